@@ -0,0 +1,666 @@
+// cobs_bench - throughput benchmarks for the nanocobs API.
+//
+// Prints one CSV row per (operation, distribution, payload size, chunk size) to stdout so
+// results can be diffed or plotted across commits. Run with --help for options.
+//
+// encode_mt and decode_mt rows time the parallel cobs::encode and cobs::decode at each
+// thread count from 1 up to --threads.
+//
+// Multi-frame rows decode a stream of back-to-back frames of |chunk| payload bytes each,
+// totalling |size| payload bytes, once with cobs_decode_frames and then with the parallel
+// cobs::decode_frames at each thread count from 1 up to --threads.
+//
+// With --counters, each row also reports per-byte hardware counters (cycles, instructions,
+// branch misses, L1d misses) from Linux perf events, measured over the same timed loop.
+// Columns are left empty when the counters are unavailable.
+
+#include "../cobs.h"
+#include "../cobs_fixed.h"
+#include "../cobs_parallel.h"
+#include "../cobs_views.h"
+#include "../tests/byte_vec.h"
+#include "perf_counters.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+using clock_type = std::chrono::steady_clock;
+
+struct options {
+  size_t max_size{ size_t{ 64 } * 1024 * 1024 };
+  double min_time_s{ 0.05 };
+  std::string filter;
+  std::vector<cobs_kernel_t> kernels{ COBS_KERNEL_AUTO };
+  unsigned max_threads{ std::max(1u, std::thread::hardware_concurrency()) };
+  bool want_counters{ false };
+  bool header{ true };
+  perf_counters* counters{ nullptr };
+  std::vector<std::unique_ptr<cobs::thread_pool>> pools;  // 1, 2, 4, ..., max_threads
+};
+
+size_t const s_sizes[]{ 8,     64,          254,          512,
+                        4096,  65536,       1024 * 1024,  16 * 1024 * 1024,
+                        64 * 1024 * 1024 };
+
+#ifdef COBS_SPEED
+char const s_profile[]{ "speed" };
+#else
+char const s_profile[]{ "size" };
+#endif
+
+size_t const s_chunks[]{ 16, 64, 256, 4096 };
+
+size_t const s_frame_sizes[]{ 64, 1024, 16384 };
+
+enum class dist { all_zero, no_zero, random, sparse_zero, runs_254 };
+dist const s_dists[]{ dist::all_zero, dist::no_zero, dist::random, dist::sparse_zero,
+                      dist::runs_254 };
+
+char const* dist_name(dist d) {
+  switch (d) {
+    case dist::all_zero: return "all_zero";
+    case dist::no_zero: return "no_zero";
+    case dist::random: return "random";
+    case dist::sparse_zero: return "sparse_zero";
+    case dist::runs_254: return "runs_254";
+  }
+  return "?";
+}
+
+char const* kernel_name(cobs_kernel_t k) {
+  switch (k) {
+    case COBS_KERNEL_AUTO: return "auto";
+    case COBS_KERNEL_SCALAR: return "scalar";
+    case COBS_KERNEL_SWAR: return "swar";
+    case COBS_KERNEL_SSE2: return "sse2";
+    case COBS_KERNEL_AVX2: return "avx2";
+  }
+  return "?";
+}
+
+byte_vec_t make_payload(dist d, size_t len) {
+  byte_vec_t v(len);
+  std::mt19937 mt{ 1234u };
+  switch (d) {
+    case dist::all_zero: break;
+    case dist::no_zero:
+      std::generate(v.begin(), v.end(), [&]() { return byte_t(1 + (mt() % 255)); });
+      break;
+    case dist::random:
+      std::generate(v.begin(), v.end(), [&]() { return byte_t(mt()); });
+      break;
+    case dist::sparse_zero:  // roughly one zero per KiB
+      std::generate(v.begin(), v.end(), [&]() {
+        return (mt() % 1024) ? byte_t(1 + (mt() % 255)) : byte_t(0);
+      });
+      break;
+    // 254 nonzero bytes then a zero, repeated: each encodes as a full 0xFF block followed
+    // by an empty 0x01 block, so the longest runs alternate with the shortest.
+    case dist::runs_254:
+      for (size_t i{ 0 }; i < len; ++i) {
+        v[i] = ((i % 255) == 254) ? 0 : 0xA5;
+      }
+      break;
+  }
+  return v;
+}
+
+struct measurement {
+  double s_per_call;
+  perf_sample per_call;  // counter totals divided by the iteration count
+};
+
+// Repeats |fn| until |min_time_s| has elapsed and returns the per-call cost. If |counters|
+// is non-null, they are sampled around the same loop that produced the timing.
+measurement time_per_call(double min_time_s,
+                          perf_counters* counters,
+                          std::function<void()> const& fn) {
+  fn();  // warm caches and page in buffers
+  size_t iters{ 1 };
+  for (;;) {
+    if (counters) {
+      counters->start();
+    }
+    auto const start{ clock_type::now() };
+    for (size_t i{ 0 }; i < iters; ++i) {
+      fn();
+    }
+    std::chrono::duration<double> const dt{ clock_type::now() - start };
+    perf_sample sample{ counters ? counters->stop() : perf_sample{} };
+    double const elapsed{ dt.count() };
+    if (elapsed >= min_time_s) {
+      for (double& v : sample.values) {
+        v = (v < 0) ? v : v / double(iters);
+      }
+      return { elapsed / double(iters), sample };
+    }
+    size_t const scaled{ size_t(double(iters) * min_time_s / std::max(elapsed, 1e-9)) };
+    iters = std::max(iters * 2, scaled);
+  }
+}
+
+void check(cobs_ret_t r, char const* what) {
+  if (r != COBS_RET_SUCCESS) {
+    std::fprintf(stderr, "cobs_bench: %s failed (%d)\n", what, int(r));
+    std::exit(1);
+  }
+}
+
+struct bench_case {
+  options const& opts;
+  cobs_kernel_t kernel;
+  dist d;
+  byte_vec_t const& dec;
+  byte_vec_t const& enc;
+
+  void report(char const* op, size_t chunk, unsigned threads, measurement const& m) const {
+    std::printf("%s,%s,%s,%s,%zu,%zu,%u,%.1f,%.3f",
+                s_profile,
+                op,
+                kernel_name(cobs_get_kernel()),
+                dist_name(d),
+                dec.size(),
+                chunk,
+                threads,
+                m.s_per_call * 1e9,
+                double(dec.size()) / m.s_per_call / 1e9);
+    if (opts.counters) {
+      for (double const v : m.per_call.values) {
+        if (v < 0) {
+          std::printf(",");
+        } else {
+          std::printf(",%.3f", v / double(std::max(dec.size(), size_t{ 1 })));
+        }
+      }
+    }
+    std::printf("\n");
+    std::fflush(stdout);
+  }
+
+  bool wants(char const* op) const {
+    return opts.filter.empty() || (std::string(op).find(opts.filter) != std::string::npos);
+  }
+
+  void run(char const* op,
+           size_t chunk,
+           std::function<void()> const& fn,
+           unsigned threads = 1) const {
+    if (wants(op)) {
+      report(op, chunk, threads, time_per_call(opts.min_time_s, opts.counters, fn));
+    }
+  }
+};
+
+void bench_one_shot(bench_case const& bc, byte_vec_t& scratch) {
+  bc.run("encode", 0, [&]() {
+    size_t len;
+    check(cobs_encode(bc.dec.data(), bc.dec.size(), scratch.data(), scratch.size(), &len),
+          "cobs_encode");
+  });
+
+  bc.run("encoded_len", 0, [&]() {
+    size_t len;
+    check(cobs_encoded_len(bc.dec.data(), bc.dec.size(), &len), "cobs_encoded_len");
+  });
+
+  // An 8-byte header and 4-byte trailer around the rest, as three segments.
+  if (bc.dec.size() >= 12) {
+    cobs_src_seg_t const segs[]{ { bc.dec.data(), 8 },
+                                 { bc.dec.data() + 8, bc.dec.size() - 12 },
+                                 { bc.dec.data() + bc.dec.size() - 4, 4 } };
+    bc.run("encode_gather", 0, [&]() {
+      size_t len;
+      check(cobs_encode_gather(segs, 3, scratch.data(), scratch.size(), &len),
+            "cobs_encode_gather");
+    });
+  }
+
+  // Encoding in place consumes its input too, so each iteration starts from a fresh copy.
+  bc.run("encode_inplace", 0, [&]() {
+    std::memcpy(scratch.data(), bc.dec.data(), bc.dec.size());
+    size_t len;
+    check(cobs_encode_inplace(scratch.data(), bc.dec.size(), scratch.size(), &len),
+          "cobs_encode_inplace");
+  });
+
+  for (auto const& pool : bc.opts.pools) {
+    bc.run(
+        "encode_mt",
+        0,
+        [&]() {
+          size_t len;
+          check(cobs::encode(*pool,
+                             bc.dec.data(),
+                             bc.dec.size(),
+                             scratch.data(),
+                             scratch.size(),
+                             &len),
+                "cobs::encode");
+        },
+        pool->size());
+  }
+
+  bc.run("decode", 0, [&]() {
+    size_t len;
+    check(cobs_decode(bc.enc.data(), bc.enc.size(), scratch.data(), scratch.size(), &len),
+          "cobs_decode");
+  });
+
+  bc.run("decoded_len", 0, [&]() {
+    size_t len;
+    check(cobs_decoded_len(bc.enc.data(), bc.enc.size(), &len), "cobs_decoded_len");
+  });
+
+  // The same split on the way in: an 8-byte header, the rest, and a 4-byte trailer.
+  if (bc.dec.size() >= 12) {
+    cobs_dst_seg_t const segs[]{ { scratch.data(), 8 },
+                                 { scratch.data() + 8, bc.dec.size() - 12 },
+                                 { scratch.data() + bc.dec.size() - 4, 4 } };
+    bc.run("decode_scatter", 0, [&]() {
+      size_t len;
+      check(cobs_decode_scatter(bc.enc.data(), bc.enc.size(), segs, 3, &len),
+            "cobs_decode_scatter");
+    });
+  }
+
+  // The frame sits in a ring with its midpoint at the wrap, as received by DMA.
+  {
+    byte_vec_t ring_buf(bc.enc.size() + 1);
+    size_t const start{ ring_buf.size() - bc.enc.size() / 2 };
+    for (size_t i{ 0 }; i < bc.enc.size(); ++i) {
+      ring_buf[(start + i) % ring_buf.size()] = bc.enc[i];
+    }
+    cobs_ring_t ring{ ring_buf.data(), ring_buf.size(), start, start - 1 };
+    bc.run("decode_ring", 0, [&]() {
+      ring.head = start;
+      cobs_decode_inc_ctx_t ctx;
+      cobs_decode_inc_begin(&ctx);
+      cobs_decode_ring_args_t const args{
+        &ring, nullptr, scratch.data(), scratch.size(), nullptr
+      };
+      size_t len;
+      bool complete;
+      check(cobs_decode_inc_ring(&ctx, &args, &len, &complete), "cobs_decode_inc_ring");
+    });
+  }
+
+  // Likewise for decoding in place.
+  bc.run("decode_inplace", 0, [&]() {
+    std::memcpy(scratch.data(), bc.enc.data(), bc.enc.size());
+    size_t len;
+    check(cobs_decode_inplace(scratch.data(), bc.enc.size(), &len), "cobs_decode_inplace");
+  });
+
+  for (auto const& pool : bc.opts.pools) {
+    bc.run(
+        "decode_mt",
+        0,
+        [&]() {
+          size_t len;
+          check(cobs::decode(*pool,
+                             bc.enc.data(),
+                             bc.enc.size(),
+                             scratch.data(),
+                             scratch.size(),
+                             &len),
+                "cobs::decode");
+        },
+        pool->size());
+  }
+}
+
+// CRC32C over the payload, fused into the codec (*_crc) and as a separate pass over the
+// decoded bytes (*_crc_2pass).
+void bench_crc(bench_case const& bc, byte_vec_t& scratch) {
+  bc.run("encode_crc", 0, [&]() {
+    cobs_crc_t crc;
+    cobs_crc_begin(&crc, COBS_CRC32C);
+    size_t len;
+    check(cobs_encode_crc(
+              bc.dec.data(), bc.dec.size(), scratch.data(), scratch.size(), &len, &crc),
+          "cobs_encode_crc");
+  });
+
+  bc.run("encode_crc_2pass", 0, [&]() {
+    cobs_crc_t crc;
+    cobs_crc_begin(&crc, COBS_CRC32C);
+    cobs_crc_update(&crc, bc.dec.data(), bc.dec.size());
+    size_t len;
+    check(cobs_encode(bc.dec.data(), bc.dec.size(), scratch.data(), scratch.size(), &len),
+          "cobs_encode");
+  });
+
+  bc.run("decode_crc", 0, [&]() {
+    cobs_crc_t crc;
+    cobs_crc_begin(&crc, COBS_CRC32C);
+    size_t len;
+    check(cobs_decode_crc(
+              bc.enc.data(), bc.enc.size(), scratch.data(), scratch.size(), &len, &crc),
+          "cobs_decode_crc");
+  });
+
+  bc.run("decode_crc_2pass", 0, [&]() {
+    cobs_crc_t crc;
+    cobs_crc_begin(&crc, COBS_CRC32C);
+    size_t len;
+    check(cobs_decode(bc.enc.data(), bc.enc.size(), scratch.data(), scratch.size(), &len),
+          "cobs_decode");
+    cobs_crc_update(&crc, scratch.data(), len);
+  });
+}
+
+void bench_tinyframe(bench_case const& bc, byte_vec_t& scratch) {
+  if (bc.dec.size() + 2 > COBS_TINYFRAME_SAFE_BUFFER_SIZE) {
+    return;
+  }
+  size_t const len{ bc.dec.size() + 2 };
+  scratch[0] = COBS_TINYFRAME_SENTINEL_VALUE;
+  std::memcpy(scratch.data() + 1, bc.dec.data(), bc.dec.size());
+  scratch[len - 1] = COBS_TINYFRAME_SENTINEL_VALUE;
+
+  // Encoding is destructive, so time encode+decode pairs; decoding restores the buffer.
+  bc.run("tinyframe_roundtrip", 0, [&]() {
+    check(cobs_encode_tinyframe(scratch.data(), len), "cobs_encode_tinyframe");
+    check(cobs_decode_tinyframe(scratch.data(), len), "cobs_decode_tinyframe");
+  });
+}
+
+template <size_t N>
+void bench_fixed_n(bench_case const& bc, byte_vec_t& scratch) {
+  auto const* const dec{ reinterpret_cast<std::byte const*>(bc.dec.data()) };
+  auto* const out{ reinterpret_cast<std::byte*>(scratch.data()) };
+  bc.run("encode_fixed", 0, [&]() {
+    auto const f{ cobs::encode(std::span<std::byte const, N>{ dec, N }) };
+    std::memcpy(out, f.data(), f.size());
+  });
+
+  auto const enc{ std::as_bytes(std::span{ bc.enc }) };
+  bc.run("decode_fixed", 0, [&]() {
+    check(cobs::decode(enc, std::span<std::byte, N>{ out, N }), "cobs::decode");
+  });
+}
+
+// The fixed-length templates need the payload length at compile time.
+void bench_fixed(bench_case const& bc, byte_vec_t& scratch) {
+  switch (bc.dec.size()) {
+    case 8: bench_fixed_n<8>(bc, scratch); break;
+    case 64: bench_fixed_n<64>(bc, scratch); break;
+    case 254: bench_fixed_n<254>(bc, scratch); break;
+    default: break;
+  }
+}
+
+// The range views, read a chunk at a time and copied out as a consumer would.
+void bench_views(bench_case const& bc, byte_vec_t& scratch) {
+  bc.run("encode_view", 0, [&]() {
+    auto v{ bc.dec | cobs::views::encode };
+    byte_t* out{ scratch.data() };
+    for (std::span<std::byte const> const chunk : v.chunks()) {
+      std::memcpy(out, chunk.data(), chunk.size());
+      out += chunk.size();
+    }
+  });
+
+  bc.run("decode_view", 0, [&]() {
+    auto v{ bc.enc | cobs::views::decode };
+    byte_t* out{ scratch.data() };
+    for (std::span<std::byte const> const chunk : v.chunks()) {
+      std::memcpy(out, chunk.data(), chunk.size());
+      out += chunk.size();
+    }
+    check(v.status(), "cobs::views::decode");
+  });
+}
+
+void bench_incremental(bench_case const& bc, byte_vec_t& scratch) {
+  byte_t work[255];
+  for (size_t const chunk : s_chunks) {
+    if (chunk > scratch.size()) {
+      continue;
+    }
+
+    bc.run("encode_inc", chunk, [&]() {
+      cobs_enc_ctx_t ctx;
+      check(cobs_encode_inc_begin(&ctx, work, sizeof(work)), "cobs_encode_inc_begin");
+      size_t src_pos{ 0 };
+      while (src_pos < bc.dec.size()) {
+        cobs_encode_inc_args_t const args{ .dec_src = bc.dec.data() + src_pos,
+                                           .enc_dst = scratch.data(),
+                                           .dec_src_max = bc.dec.size() - src_pos,
+                                           .enc_dst_max = chunk,
+                                           .crc = nullptr };
+        size_t src_len, dst_len;
+        check(cobs_encode_inc(&ctx, &args, &src_len, &dst_len), "cobs_encode_inc");
+        src_pos += src_len;
+      }
+      bool finished{ false };
+      while (!finished) {
+        size_t dst_len;
+        check(cobs_encode_inc_end(&ctx, scratch.data(), chunk, &dst_len, &finished),
+              "cobs_encode_inc_end");
+      }
+    });
+
+    bc.run("decode_inc", chunk, [&]() {
+      cobs_decode_inc_ctx_t ctx;
+      check(cobs_decode_inc_begin(&ctx), "cobs_decode_inc_begin");
+      size_t src_pos{ 0 };
+      bool complete{ false };
+      while (!complete) {
+        cobs_decode_inc_args_t const args{ .enc_src = bc.enc.data() + src_pos,
+                                           .dec_dst = scratch.data(),
+                                           .enc_src_max = bc.enc.size() - src_pos,
+                                           .dec_dst_max = chunk,
+                                           .crc = nullptr };
+        size_t src_len, dst_len;
+        check(cobs_decode_inc(&ctx, &args, &src_len, &dst_len, &complete),
+              "cobs_decode_inc");
+        src_pos += src_len;
+      }
+    });
+  }
+}
+
+void bench_frames(bench_case const& bc, byte_vec_t& scratch) {
+  for (size_t const frame_size : s_frame_sizes) {
+    if (frame_size >= bc.dec.size()) {
+      continue;
+    }
+
+    byte_vec_t stream;
+    size_t n_frames{ 0 };
+    for (size_t ofs{ 0 }; ofs < bc.dec.size(); ofs += frame_size, ++n_frames) {
+      size_t const len{ std::min(frame_size, bc.dec.size() - ofs) };
+      size_t const stream_len{ stream.size() };
+      stream.resize(stream_len + COBS_ENCODE_MAX(len));
+      size_t enc_len;
+      check(cobs_encode(bc.dec.data() + ofs,
+                        len,
+                        stream.data() + stream_len,
+                        COBS_ENCODE_MAX(len),
+                        &enc_len),
+            "cobs_encode");
+      stream.resize(stream_len + enc_len);
+    }
+    if (stream.size() > scratch.size()) {
+      scratch.resize(stream.size());
+    }
+    std::vector<cobs_frame_t> frames(n_frames);
+
+    auto const check_all{ [&](size_t n, size_t tail) {
+      if ((n != n_frames) || tail) {
+        std::fprintf(stderr, "cobs_bench: decoded %zu of %zu frames\n", n, n_frames);
+        std::exit(1);
+      }
+    } };
+
+    bc.run("decode_frames", frame_size, [&]() {
+      size_t n, tail;
+      check(cobs_decode_frames(stream.data(),
+                               stream.size(),
+                               scratch.data(),
+                               scratch.size(),
+                               frames.data(),
+                               frames.size(),
+                               &n,
+                               &tail),
+            "cobs_decode_frames");
+      check_all(n, tail);
+    });
+
+    for (auto const& pool : bc.opts.pools) {
+      bc.run(
+          "decode_frames_mt",
+          frame_size,
+          [&]() {
+            size_t n, tail;
+            check(cobs::decode_frames(*pool,
+                                      stream.data(),
+                                      stream.size(),
+                                      scratch.data(),
+                                      scratch.size(),
+                                      frames.data(),
+                                      frames.size(),
+                                      &n,
+                                      &tail),
+                  "cobs::decode_frames");
+            check_all(n, tail);
+          },
+          pool->size());
+    }
+  }
+}
+
+void usage() {
+  std::fprintf(stderr,
+               "usage: cobs_bench [--max-size BYTES] [--min-time SECONDS] [--filter OP]\n"
+               "                  [--kernel auto|scalar|swar|sse2|avx2|all]\n"
+               "                  [--threads N] [--counters] [--no-header]\n");
+}
+
+bool parse_kernel(char const* s, options& opts) {
+  cobs_kernel_t const all[]{ COBS_KERNEL_SCALAR, COBS_KERNEL_SWAR, COBS_KERNEL_SSE2,
+                             COBS_KERNEL_AVX2 };
+  opts.kernels.clear();
+  if (!std::strcmp(s, "all")) {
+    opts.kernels.assign(std::begin(all), std::end(all));
+    return true;
+  }
+  for (cobs_kernel_t const k : { COBS_KERNEL_AUTO,
+                                 COBS_KERNEL_SCALAR,
+                                 COBS_KERNEL_SWAR,
+                                 COBS_KERNEL_SSE2,
+                                 COBS_KERNEL_AVX2 }) {
+    if (!std::strcmp(s, kernel_name(k))) {
+      opts.kernels.push_back(k);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool parse_args(int argc, char** argv, options& opts) {
+  for (int i{ 1 }; i < argc; ++i) {
+    std::string const arg{ argv[i] };
+    if (arg == "--counters") {
+      opts.want_counters = true;
+      continue;
+    }
+    if (arg == "--no-header") {
+      opts.header = false;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      return false;
+    }
+    char const* const val{ argv[++i] };
+    if (arg == "--max-size") {
+      opts.max_size = size_t(std::strtoull(val, nullptr, 0));
+    } else if (arg == "--min-time") {
+      opts.min_time_s = std::strtod(val, nullptr);
+    } else if (arg == "--threads") {
+      opts.max_threads = std::max(1u, unsigned(std::strtoul(val, nullptr, 0)));
+    } else if (arg == "--filter") {
+      opts.filter = val;
+    } else if (arg == "--kernel") {
+      if (!parse_kernel(val, opts)) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  options opts;
+  if (!parse_args(argc, argv, opts)) {
+    usage();
+    return 1;
+  }
+
+  perf_counters counters;
+  if (opts.want_counters) {
+    if (!counters.available()) {
+      std::fprintf(stderr, "cobs_bench: perf counters unavailable, columns left empty\n");
+    }
+    opts.counters = &counters;
+  }
+
+  if (opts.header) {
+    std::printf("profile,op,kernel,dist,size,chunk,threads,ns_per_frame,gb_per_s%s\n",
+                opts.want_counters ? ",cycles_per_byte,instructions_per_byte,"
+                                     "branch_misses_per_byte,l1d_misses_per_byte"
+                                     : "");
+  }
+
+  for (unsigned t{ 1 };; t = std::min(t * 2, opts.max_threads)) {
+    opts.pools.push_back(std::make_unique<cobs::thread_pool>(t));
+    if (t == opts.max_threads) {
+      break;
+    }
+  }
+
+  for (size_t const size : s_sizes) {
+    if (size > opts.max_size) {
+      continue;
+    }
+    byte_vec_t scratch(COBS_ENCODE_MAX(size));
+
+    for (dist const d : s_dists) {
+      byte_vec_t const dec{ make_payload(d, size) };
+      byte_vec_t enc(COBS_ENCODE_MAX(size));
+      size_t enc_len;
+      check(cobs_encode(dec.data(), dec.size(), enc.data(), enc.size(), &enc_len),
+            "cobs_encode");
+      enc.resize(enc_len);
+
+      for (cobs_kernel_t const k : opts.kernels) {
+        if (cobs_set_kernel(k) != COBS_RET_SUCCESS) {
+          continue;
+        }
+        bench_case const bc{ opts, k, d, dec, enc };
+        bench_one_shot(bc, scratch);
+        bench_crc(bc, scratch);
+        bench_tinyframe(bc, scratch);
+        bench_fixed(bc, scratch);
+        bench_views(bc, scratch);
+        bench_incremental(bc, scratch);
+        bench_frames(bc, scratch);
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,111 @@
+#include "perf_counters.h"
+
+#ifdef __linux__
+  #include <linux/perf_event.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+
+  #include <cstdint>
+  #include <cstring>
+#endif
+
+namespace {
+perf_sample unavailable_sample() {
+  perf_sample s;
+  s.values.fill(-1.0);
+  return s;
+}
+}  // namespace
+
+#ifdef __linux__
+
+namespace {
+struct event_desc {
+  std::uint32_t type;
+  std::uint64_t config;
+};
+
+// Indexed by perf_counter.
+event_desc const s_events[]{
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+  { PERF_TYPE_HW_CACHE,
+    PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+};
+static_assert(sizeof(s_events) / sizeof(s_events[0]) == size_t(perf_counter::count));
+
+int open_event(event_desc const& e, int group_fd) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = e.type;
+  attr.config = e.config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  long const fd{ syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0ul) };
+  return int(fd);
+}
+}  // namespace
+
+perf_counters::perf_counters() {
+  fds_.fill(-1);
+  fds_[0] = open_event(s_events[0], -1);
+  if (fds_[0] < 0) {
+    return;
+  }
+  for (size_t i{ 1 }; i < fds_.size(); ++i) {
+    fds_[i] = open_event(s_events[i], fds_[0]);
+  }
+}
+
+perf_counters::~perf_counters() {
+  for (int const fd : fds_) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+bool perf_counters::available() const { return fds_[0] >= 0; }
+
+void perf_counters::start() {
+  if (!available()) {
+    return;
+  }
+  ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+perf_sample perf_counters::stop() {
+  perf_sample s{ unavailable_sample() };
+  if (!available()) {
+    return s;
+  }
+  ioctl(fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+  for (size_t i{ 0 }; i < fds_.size(); ++i) {
+    std::uint64_t buf[3];  // value, time_enabled, time_running
+    if ((fds_[i] < 0) || (read(fds_[i], buf, sizeof(buf)) != ssize_t(sizeof(buf))) ||
+        !buf[2]) {
+      continue;
+    }
+    // Scale up if the kernel multiplexed the group off the PMU for part of the interval.
+    s.values[i] = double(buf[0]) * (double(buf[1]) / double(buf[2]));
+  }
+  return s;
+}
+
+#else
+
+perf_counters::perf_counters() { fds_.fill(-1); }
+perf_counters::~perf_counters() = default;
+bool perf_counters::available() const { return false; }
+void perf_counters::start() {}
+perf_sample perf_counters::stop() { return unavailable_sample(); }
+
+#endif
@@ -0,0 +1,47 @@
+// perf_counters - optional hardware performance counters for cobs_bench.
+//
+// On Linux this wraps a perf_event_open(2) group of cycles, instructions, branch misses
+// and L1d read misses, counting user space on the calling thread only. Elsewhere, or when
+// the kernel refuses the events (containers, perf_event_paranoid, VMs without a PMU),
+// every counter reports unavailable and the benchmark keeps its wall-clock numbers.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+enum class perf_counter : size_t {
+  cycles,
+  instructions,
+  branch_misses,
+  l1d_misses,
+  count
+};
+
+// Counter totals for one measured interval, scaled for multiplexing. A negative value
+// means that counter could not be read.
+struct perf_sample {
+  std::array<double, size_t(perf_counter::count)> values;
+
+  double operator[](perf_counter c) const { return values[size_t(c)]; }
+};
+
+class perf_counters {
+ public:
+  perf_counters();
+  ~perf_counters();
+  perf_counters(perf_counters const&) = delete;
+  perf_counters& operator=(perf_counters const&) = delete;
+
+  // True if at least the cycle counter opened; individual members may still be missing.
+  bool available() const;
+
+  // Resets and enables every open counter.
+  void start();
+
+  // Disables the counters and returns their totals since start().
+  perf_sample stop();
+
+ private:
+  std::array<int, size_t(perf_counter::count)> fds_;
+};
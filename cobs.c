@@ -3,6 +3,770 @@
 
 #define COBS_TFSV COBS_TINYFRAME_SENTINEL_VALUE
 
+// Zero-scan and block-copy kernels.
+//
+// By default only the portable byte-at-a-time loops are built, which keeps the library
+// small. Define COBS_SWAR to scan a machine word at a time instead. COBS_SPEED (set by
+// the Makefile's speed profile) trades code size for throughput: it implies COBS_SWAR,
+// and on x86 adds SSE2 and AVX2 kernels with unrolled loops.
+//
+// The x86 kernels use GCC/clang vector extensions and builtins instead of <immintrin.h>,
+// which pulls in <stdlib.h> on some toolchains. They're all compiled with per-function
+// target attributes and the best one for the running CPU is picked on first use (see
+// cobs_set_kernel). Define COBS_NO_DISPATCH to instead choose at compile time from the -m
+// flags, and COBS_NO_SIMD to keep the portable loops.
+#if defined(COBS_SPEED) && !defined(COBS_SWAR)
+  #define COBS_SWAR
+#endif
+
+#if defined(COBS_SPEED) && !defined(COBS_NO_SIMD) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+  #ifdef COBS_NO_DISPATCH
+    #ifdef __SSE2__
+      #define COBS_SSE2
+    #endif
+    #ifdef __AVX2__
+      #define COBS_AVX2
+    #endif
+  #else
+    #define COBS_DISPATCH
+    #define COBS_SSE2
+    #define COBS_AVX2
+  #endif
+#endif
+
+#if defined(COBS_SWAR) || defined(COBS_DISPATCH)
+  #define COBS_HAVE_SWAR
+#endif
+
+#ifdef COBS_DISPATCH
+  #include <cpuid.h>  // compiler-provided, not libc
+#endif
+
+// Returns the index of the first zero byte in |p[0..n)|, or |n| if there is none.
+static inline size_t cobs_scan_scalar(cobs_byte_t const* p, size_t n) {
+  size_t i = 0;
+  while ((i < n) && p[i]) {
+    ++i;
+  }
+  return i;
+}
+
+// Copies |n| bytes from |src| to |dst|. |dst| may overlap |src| if it starts at or before
+// |src|, so the copy kernels can compact a buffer leftward.
+static inline void cobs_copy_scalar(cobs_byte_t* dst, cobs_byte_t const* src, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = src[i];
+  }
+}
+
+// Copies bytes from |src| to |dst| until a zero byte or |n| bytes, returning how many were
+// copied. Bytes of |dst| past the returned count may be overwritten. Same overlap rule as
+// the copy kernels.
+static inline size_t cobs_copy_run_scalar(cobs_byte_t* dst,
+                                          cobs_byte_t const* src,
+                                          size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    cobs_byte_t const b = src[i];
+    if (!b) {
+      return i;
+    }
+    dst[i] = b;
+  }
+  return n;
+}
+
+#ifdef COBS_HAVE_SWAR
+  #if UINTPTR_MAX > 0xFFFFFFFFu
+typedef uint64_t cobs_word_t;
+  #else
+typedef uint32_t cobs_word_t;
+  #endif
+
+  #ifdef __GNUC__
+typedef cobs_word_t __attribute__((may_alias)) cobs_word_alias_t;
+  #else
+typedef cobs_word_t cobs_word_alias_t;
+  #endif
+
+// Classic "has zero byte" test on aligned words; the scalar loop pins down which byte.
+static inline size_t cobs_scan_swar(cobs_byte_t const* p, size_t n) {
+  cobs_word_t const ones = (cobs_word_t)-1 / 0xFF;
+  cobs_word_t const highs = (cobs_word_t)(ones << 7);
+  size_t i = 0;
+  while ((i < n) && ((uintptr_t)(p + i) & (sizeof(cobs_word_t) - 1))) {
+    if (!p[i]) {
+      return i;
+    }
+    ++i;
+  }
+  for (; i + sizeof(cobs_word_t) <= n; i += sizeof(cobs_word_t)) {
+    cobs_word_t const w = *(cobs_word_alias_t const*)(void const*)(p + i);
+    if ((cobs_word_t)(w - ones) & ~w & highs) {
+      break;
+    }
+  }
+  return i + cobs_scan_scalar(p + i, n - i);
+}
+#endif
+
+#ifdef COBS_HAVE_SWAR
+static inline size_t cobs_copy_run_swar(cobs_byte_t* dst,
+                                        cobs_byte_t const* src,
+                                        size_t n) {
+  size_t const run = cobs_scan_swar(src, n);
+  cobs_copy_scalar(dst, src, run);
+  return run;
+}
+#endif
+
+#ifdef COBS_SSE2
+typedef char cobs_v16_t __attribute__((vector_size(16), aligned(1), may_alias));
+  #define COBS_TARGET_SSE2 __attribute__((target("sse2")))
+
+COBS_TARGET_SSE2 static inline cobs_v16_t cobs_load16(cobs_byte_t const* p) {
+  return *(cobs_v16_t const*)(void const*)p;
+}
+
+COBS_TARGET_SSE2 static inline void cobs_store16(cobs_byte_t* p, cobs_v16_t v) {
+  *(cobs_v16_t*)(void*)p = v;
+}
+
+COBS_TARGET_SSE2 static inline unsigned cobs_zero_mask16(cobs_v16_t v) {
+  return (unsigned)__builtin_ia32_pmovmskb128((cobs_v16_t)(v == (cobs_v16_t){ 0 }));
+}
+
+  #ifdef COBS_SPEED
+COBS_TARGET_SSE2 static inline bool cobs_any_zero16x2(cobs_v16_t a, cobs_v16_t b) {
+  cobs_v16_t const z = { 0 };
+  return __builtin_ia32_pmovmskb128((cobs_v16_t)((a == z) | (b == z))) != 0;
+}
+  #endif
+
+COBS_TARGET_SSE2 static inline size_t cobs_scan_sse2(cobs_byte_t const* p, size_t n) {
+  if (n < 16) {
+    return cobs_scan_scalar(p, n);
+  }
+  size_t i = 0;
+  #ifdef COBS_SPEED
+  // Two vectors per iteration; the loop below pinpoints the zero once one shows up.
+  for (; i + 32 <= n; i += 32) {
+    if (cobs_any_zero16x2(cobs_load16(p + i), cobs_load16(p + i + 16))) {
+      break;
+    }
+  }
+  #endif
+  for (; i + 16 <= n; i += 16) {
+    unsigned const m = cobs_zero_mask16(cobs_load16(p + i));
+    if (m) {
+      return i + (size_t)__builtin_ctz(m);
+    }
+  }
+  if (i < n) {  // overlapping final load; bytes before |i| are already known nonzero
+    unsigned const m = cobs_zero_mask16(cobs_load16(p + n - 16));
+    if (m) {
+      return n - 16 + (size_t)__builtin_ctz(m);
+    }
+  }
+  return n;
+}
+
+COBS_TARGET_SSE2 static inline void cobs_copy_sse2(cobs_byte_t* dst,
+                                                   cobs_byte_t const* src,
+                                                   size_t n) {
+  if (n < 16) {
+    cobs_copy_scalar(dst, src, n);
+    return;
+  }
+  // Load the tail first so the overlapping final store is safe when |dst| < |src|.
+  cobs_v16_t const tail = cobs_load16(src + n - 16);
+  for (size_t i = 0; i + 16 <= n; i += 16) {
+    cobs_store16(dst + i, cobs_load16(src + i));
+  }
+  cobs_store16(dst + n - 16, tail);
+}
+
+COBS_TARGET_SSE2 static inline size_t cobs_copy_run_sse2(cobs_byte_t* dst,
+                                                         cobs_byte_t const* src,
+                                                         size_t n) {
+  if (n < 16) {
+    return cobs_copy_run_scalar(dst, src, n);
+  }
+  cobs_v16_t const tail = cobs_load16(src + n - 16);
+  size_t i = 0;
+  #ifdef COBS_SPEED
+  for (; i + 32 <= n; i += 32) {
+    cobs_v16_t const a = cobs_load16(src + i), b = cobs_load16(src + i + 16);
+    if (cobs_any_zero16x2(a, b)) {
+      break;
+    }
+    cobs_store16(dst + i, a);
+    cobs_store16(dst + i + 16, b);
+  }
+  #endif
+  for (; i + 16 <= n; i += 16) {
+    cobs_v16_t const v = cobs_load16(src + i);
+    unsigned const m = cobs_zero_mask16(v);
+    if (m) {
+      return i + (size_t)__builtin_ctz(m);
+    }
+    cobs_store16(dst + i, v);
+  }
+  if (i < n) {
+    unsigned const m = cobs_zero_mask16(tail);
+    if (m) {
+      return n - 16 + (size_t)__builtin_ctz(m);
+    }
+    cobs_store16(dst + n - 16, tail);
+  }
+  return n;
+}
+#endif
+
+#ifdef COBS_AVX2
+typedef char cobs_v32_t __attribute__((vector_size(32), aligned(1), may_alias));
+  #define COBS_TARGET_AVX2 __attribute__((target("avx2")))
+
+COBS_TARGET_AVX2 static inline cobs_v32_t cobs_load32(cobs_byte_t const* p) {
+  return *(cobs_v32_t const*)(void const*)p;
+}
+
+COBS_TARGET_AVX2 static inline void cobs_store32(cobs_byte_t* p, cobs_v32_t v) {
+  *(cobs_v32_t*)(void*)p = v;
+}
+
+COBS_TARGET_AVX2 static inline unsigned cobs_zero_mask32(cobs_v32_t v) {
+  return (unsigned)__builtin_ia32_pmovmskb256((cobs_v32_t)(v == (cobs_v32_t){ 0 }));
+}
+
+  #ifdef COBS_SPEED
+COBS_TARGET_AVX2 static inline bool cobs_any_zero32x2(cobs_v32_t a, cobs_v32_t b) {
+  cobs_v32_t const z = { 0 };
+  return __builtin_ia32_pmovmskb256((cobs_v32_t)((a == z) | (b == z))) != 0;
+}
+  #endif
+
+// The AVX2 kernels end with vzeroupper; gcc doesn't always insert it (e.g. at -Os), and
+// dirty upper YMM state makes the surrounding SSE code pay transition penalties.
+COBS_TARGET_AVX2 static inline size_t cobs_scan_avx2(cobs_byte_t const* p, size_t n) {
+  if (n < 32) {
+    return cobs_scan_sse2(p, n);
+  }
+  size_t i = 0, found = n;
+  #ifdef COBS_SPEED
+  for (; i + 64 <= n; i += 64) {
+    if (cobs_any_zero32x2(cobs_load32(p + i), cobs_load32(p + i + 32))) {
+      break;
+    }
+  }
+  #endif
+  for (; i + 32 <= n; i += 32) {
+    unsigned const m = cobs_zero_mask32(cobs_load32(p + i));
+    if (m) {
+      found = i + (size_t)__builtin_ctz(m);
+      break;
+    }
+  }
+  if ((found == n) && (i < n)) {
+    unsigned const m = cobs_zero_mask32(cobs_load32(p + n - 32));
+    if (m) {
+      found = n - 32 + (size_t)__builtin_ctz(m);
+    }
+  }
+  __builtin_ia32_vzeroupper();
+  return found;
+}
+
+COBS_TARGET_AVX2 static inline void cobs_copy_avx2(cobs_byte_t* dst,
+                                                   cobs_byte_t const* src,
+                                                   size_t n) {
+  if (n < 32) {
+    cobs_copy_sse2(dst, src, n);
+    return;
+  }
+  cobs_v32_t const tail = cobs_load32(src + n - 32);
+  for (size_t i = 0; i + 32 <= n; i += 32) {
+    cobs_store32(dst + i, cobs_load32(src + i));
+  }
+  cobs_store32(dst + n - 32, tail);
+  __builtin_ia32_vzeroupper();
+}
+
+COBS_TARGET_AVX2 static inline size_t cobs_copy_run_avx2(cobs_byte_t* dst,
+                                                         cobs_byte_t const* src,
+                                                         size_t n) {
+  if (n < 32) {
+    return cobs_copy_run_sse2(dst, src, n);
+  }
+  cobs_v32_t const tail = cobs_load32(src + n - 32);
+  size_t i = 0, copied = n;
+  #ifdef COBS_SPEED
+  for (; i + 64 <= n; i += 64) {
+    cobs_v32_t const a = cobs_load32(src + i), b = cobs_load32(src + i + 32);
+    if (cobs_any_zero32x2(a, b)) {
+      break;
+    }
+    cobs_store32(dst + i, a);
+    cobs_store32(dst + i + 32, b);
+  }
+  #endif
+  for (; i + 32 <= n; i += 32) {
+    cobs_v32_t const v = cobs_load32(src + i);
+    unsigned const m = cobs_zero_mask32(v);
+    if (m) {
+      copied = i + (size_t)__builtin_ctz(m);
+      break;
+    }
+    cobs_store32(dst + i, v);
+  }
+  if ((copied == n) && (i < n)) {
+    unsigned const m = cobs_zero_mask32(tail);
+    if (m) {
+      copied = n - 32 + (size_t)__builtin_ctz(m);
+    } else {
+      cobs_store32(dst + n - 32, tail);
+    }
+  }
+  __builtin_ia32_vzeroupper();
+  return copied;
+}
+#endif
+
+#ifdef COBS_DISPATCH
+typedef struct cobs_kernel_ops {
+  size_t (*scan)(cobs_byte_t const* p, size_t n);
+  void (*copy)(cobs_byte_t* dst, cobs_byte_t const* src, size_t n);
+  size_t (*copy_run)(cobs_byte_t* dst, cobs_byte_t const* src, size_t n);
+} cobs_kernel_ops_t;
+
+static cobs_kernel_ops_t const s_kernel_ops[] = {
+  [COBS_KERNEL_SCALAR] = { cobs_scan_scalar, cobs_copy_scalar, cobs_copy_run_scalar },
+  [COBS_KERNEL_SWAR] = { cobs_scan_swar, cobs_copy_scalar, cobs_copy_run_swar },
+  [COBS_KERNEL_SSE2] = { cobs_scan_sse2, cobs_copy_sse2, cobs_copy_run_sse2 },
+  [COBS_KERNEL_AVX2] = { cobs_scan_avx2, cobs_copy_avx2, cobs_copy_run_avx2 },
+};
+
+static size_t cobs_scan_resolve(cobs_byte_t const* p, size_t n);
+static void cobs_copy_resolve(cobs_byte_t* dst, cobs_byte_t const* src, size_t n);
+static size_t cobs_copy_run_resolve(cobs_byte_t* dst, cobs_byte_t const* src, size_t n);
+static cobs_kernel_ops_t const s_resolve_ops = { cobs_scan_resolve,
+                                                 cobs_copy_resolve,
+                                                 cobs_copy_run_resolve };
+
+// Starts out pointing at stubs that pick a kernel on first use. Threads may resolve
+// concurrently, so it's only accessed atomically: the release store in cobs_use_kernel
+// publishes |s_crc32c_hw| along with it, and readers load it with acquire.
+static cobs_kernel_ops_t const* s_ops = &s_resolve_ops;
+
+static inline cobs_kernel_ops_t const* cobs_ops(void) {
+  return __atomic_load_n(&s_ops, __ATOMIC_ACQUIRE);
+}
+
+static bool cobs_cpu_supports(cobs_kernel_t kernel) {
+  unsigned a, b, c, d;
+  switch (kernel) {
+    case COBS_KERNEL_SCALAR:
+    case COBS_KERNEL_SWAR:
+      return true;
+
+    case COBS_KERNEL_SSE2:
+      return __get_cpuid(1, &a, &b, &c, &d) && (d & bit_SSE2);
+
+    case COBS_KERNEL_AVX2: {
+      // The CPU must have AVX2 and the OS must save YMM state (OSXSAVE + XCR0 bits 1-2).
+      if ((__get_cpuid_max(0, 0) < 7) || !__get_cpuid(1, &a, &b, &c, &d) ||
+          !(c & bit_OSXSAVE)) {
+        return false;
+      }
+      unsigned xcr0_lo, xcr0_hi;
+      __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+      (void)xcr0_hi;
+      if ((xcr0_lo & 0x6) != 0x6) {
+        return false;
+      }
+      __cpuid_count(7, 0, a, b, c, d);
+      return (b & bit_AVX2) != 0;
+    }
+
+    case COBS_KERNEL_AUTO:
+      break;
+  }
+  return false;
+}
+
+// Whether CRC32C uses the SSE4.2 crc32 instruction. It follows the kernel, so forcing the
+// scalar or SWAR kernel also forces the portable CRC. Read after an acquire of |s_ops|.
+static bool s_crc32c_hw = false;
+
+static void cobs_use_kernel(cobs_kernel_t kernel) {
+  unsigned a, b, c, d;
+  bool const crc32c_hw = (kernel >= COBS_KERNEL_SSE2) &&
+                         __get_cpuid(1, &a, &b, &c, &d) && (c & bit_SSE4_2);
+  __atomic_store_n(&s_crc32c_hw, crc32c_hw, __ATOMIC_RELAXED);
+  __atomic_store_n(&s_ops, &s_kernel_ops[kernel], __ATOMIC_RELEASE);
+}
+
+static cobs_kernel_t cobs_best_kernel(void) {
+  if (cobs_cpu_supports(COBS_KERNEL_AVX2)) {
+    return COBS_KERNEL_AVX2;
+  }
+  return cobs_cpu_supports(COBS_KERNEL_SSE2) ? COBS_KERNEL_SSE2 : COBS_KERNEL_SWAR;
+}
+
+static size_t cobs_scan_resolve(cobs_byte_t const* p, size_t n) {
+  cobs_use_kernel(cobs_best_kernel());
+  return cobs_ops()->scan(p, n);
+}
+
+static void cobs_copy_resolve(cobs_byte_t* dst, cobs_byte_t const* src, size_t n) {
+  cobs_use_kernel(cobs_best_kernel());
+  cobs_ops()->copy(dst, src, n);
+}
+
+static size_t cobs_copy_run_resolve(cobs_byte_t* dst, cobs_byte_t const* src, size_t n) {
+  cobs_use_kernel(cobs_best_kernel());
+  return cobs_ops()->copy_run(dst, src, n);
+}
+
+static inline size_t cobs_scan(cobs_byte_t const* p, size_t n) {
+  return cobs_ops()->scan(p, n);
+}
+
+static inline void cobs_copy(cobs_byte_t* dst, cobs_byte_t const* src, size_t n) {
+  cobs_ops()->copy(dst, src, n);
+}
+
+static inline size_t cobs_copy_run(cobs_byte_t* dst, cobs_byte_t const* src, size_t n) {
+  return cobs_ops()->copy_run(dst, src, n);
+}
+
+cobs_ret_t cobs_set_kernel(cobs_kernel_t kernel) {
+  if (kernel == COBS_KERNEL_AUTO) {
+    cobs_use_kernel(cobs_best_kernel());
+    return COBS_RET_SUCCESS;
+  }
+  if ((kernel > COBS_KERNEL_AVX2) || !cobs_cpu_supports(kernel)) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+  cobs_use_kernel(kernel);
+  return COBS_RET_SUCCESS;
+}
+
+cobs_kernel_t cobs_get_kernel(void) {
+  cobs_kernel_ops_t const* ops = cobs_ops();
+  if (ops == &s_resolve_ops) {
+    cobs_use_kernel(cobs_best_kernel());
+    ops = cobs_ops();
+  }
+  return (cobs_kernel_t)(ops - s_kernel_ops);
+}
+
+#else
+
+  #if defined(COBS_AVX2)
+    #define COBS_STATIC_KERNEL COBS_KERNEL_AVX2
+  #elif defined(COBS_SSE2)
+    #define COBS_STATIC_KERNEL COBS_KERNEL_SSE2
+  #elif defined(COBS_HAVE_SWAR)
+    #define COBS_STATIC_KERNEL COBS_KERNEL_SWAR
+  #else
+    #define COBS_STATIC_KERNEL COBS_KERNEL_SCALAR
+  #endif
+
+static inline size_t cobs_scan(cobs_byte_t const* p, size_t n) {
+  #if defined(COBS_AVX2)
+  return cobs_scan_avx2(p, n);
+  #elif defined(COBS_SSE2)
+  return cobs_scan_sse2(p, n);
+  #elif defined(COBS_HAVE_SWAR)
+  return cobs_scan_swar(p, n);
+  #else
+  return cobs_scan_scalar(p, n);
+  #endif
+}
+
+static inline void cobs_copy(cobs_byte_t* dst, cobs_byte_t const* src, size_t n) {
+  #if defined(COBS_AVX2)
+  cobs_copy_avx2(dst, src, n);
+  #elif defined(COBS_SSE2)
+  cobs_copy_sse2(dst, src, n);
+  #else
+  cobs_copy_scalar(dst, src, n);
+  #endif
+}
+
+static inline size_t cobs_copy_run(cobs_byte_t* dst, cobs_byte_t const* src, size_t n) {
+  #if defined(COBS_AVX2)
+  return cobs_copy_run_avx2(dst, src, n);
+  #elif defined(COBS_SSE2)
+  return cobs_copy_run_sse2(dst, src, n);
+  #elif defined(COBS_HAVE_SWAR)
+  return cobs_copy_run_swar(dst, src, n);
+  #else
+  return cobs_copy_run_scalar(dst, src, n);
+  #endif
+}
+
+cobs_ret_t cobs_set_kernel(cobs_kernel_t kernel) {
+  return ((kernel == COBS_KERNEL_AUTO) || (kernel == COBS_STATIC_KERNEL))
+             ? COBS_RET_SUCCESS
+             : COBS_RET_ERR_BAD_ARG;
+}
+
+cobs_kernel_t cobs_get_kernel(void) {
+  return COBS_STATIC_KERNEL;
+}
+#endif
+
+// CRCs, folded in a block at a time while the block is still in L1. The size profile
+// looks up a nibble at a time in 16-entry tables; COBS_SPEED looks up whole bytes in
+// 256-entry ones. On x86, CRC32C uses the SSE4.2 crc32 instruction when it can.
+#ifdef COBS_SPEED
+static uint16_t const s_crc16_ccitt_table[256] = {
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+  0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+  0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+  0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+  0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+  0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+  0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+  0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+  0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+  0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+  0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+  0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+  0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+  0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+  0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+  0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+  0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+  0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+  0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+  0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+  0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+  0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+  0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+  0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+  0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+  0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+  0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+  0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+  0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+  0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+  0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+static uint32_t const s_crc32_table[256] = {
+  0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F, 0xE963A535,
+  0x9E6495A3, 0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988, 0x09B64C2B, 0x7EB17CBD,
+  0xE7B82D07, 0x90BF1D91, 0x1DB71064, 0x6AB020F2, 0xF3B97148, 0x84BE41DE, 0x1ADAD47D,
+  0x6DDDE4EB, 0xF4D4B551, 0x83D385C7, 0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC,
+  0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5, 0x3B6E20C8, 0x4C69105E, 0xD56041E4,
+  0xA2677172, 0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B, 0x35B5A8FA, 0x42B2986C,
+  0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59, 0x26D930AC,
+  0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423, 0xCFBA9599, 0xB8BDA50F,
+  0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924, 0x2F6F7C87, 0x58684C11, 0xC1611DAB,
+  0xB6662D3D, 0x76DC4190, 0x01DB7106, 0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F,
+  0x9FBFE4A5, 0xE8B8D433, 0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB,
+  0x086D3D2D, 0x91646C97, 0xE6635C01, 0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E,
+  0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457, 0x65B0D9C6, 0x12B7E950, 0x8BBEB8EA,
+  0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65, 0x4DB26158, 0x3AB551CE,
+  0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB, 0x4369E96A,
+  0x346ED9FC, 0xAD678846, 0xDA60B8D0, 0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9,
+  0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409,
+  0xCE61E49F, 0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81,
+  0xB7BD5C3B, 0xC0BA6CAD, 0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A, 0xEAD54739,
+  0x9DD277AF, 0x04DB2615, 0x73DC1683, 0xE3630B12, 0x94643B84, 0x0D6D6A3E, 0x7A6A5AA8,
+  0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1, 0xF00F9344, 0x8708A3D2, 0x1E01F268,
+  0x6906C2FE, 0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7, 0xFED41B76, 0x89D32BE0,
+  0x10DA7A5A, 0x67DD4ACC, 0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5, 0xD6D6A3E8,
+  0xA1D1937E, 0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+  0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55, 0x316E8EEF,
+  0x4669BE79, 0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236, 0xCC0C7795, 0xBB0B4703,
+  0x220216B9, 0x5505262F, 0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7,
+  0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D, 0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A,
+  0x9C0906A9, 0xEB0E363F, 0x72076785, 0x05005713, 0x95BF4A82, 0xE2B87A14, 0x7BB12BAE,
+  0x0CB61B38, 0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21, 0x86D3D2D4, 0xF1D4E242,
+  0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777, 0x88085AE6,
+  0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45,
+  0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2, 0xA7672661, 0xD06016F7, 0x4969474D,
+  0x3E6E77DB, 0xAED16A4A, 0xD9D65ADC, 0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5,
+  0x47B2CF7F, 0x30B5FFE9, 0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605,
+  0xCDD70693, 0x54DE5729, 0x23D967BF, 0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
+  0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
+};
+static uint32_t const s_crc32c_table[256] = {
+  0x00000000, 0xF26B8303, 0xE13B70F7, 0x1350F3F4, 0xC79A971F, 0x35F1141C, 0x26A1E7E8,
+  0xD4CA64EB, 0x8AD958CF, 0x78B2DBCC, 0x6BE22838, 0x9989AB3B, 0x4D43CFD0, 0xBF284CD3,
+  0xAC78BF27, 0x5E133C24, 0x105EC76F, 0xE235446C, 0xF165B798, 0x030E349B, 0xD7C45070,
+  0x25AFD373, 0x36FF2087, 0xC494A384, 0x9A879FA0, 0x68EC1CA3, 0x7BBCEF57, 0x89D76C54,
+  0x5D1D08BF, 0xAF768BBC, 0xBC267848, 0x4E4DFB4B, 0x20BD8EDE, 0xD2D60DDD, 0xC186FE29,
+  0x33ED7D2A, 0xE72719C1, 0x154C9AC2, 0x061C6936, 0xF477EA35, 0xAA64D611, 0x580F5512,
+  0x4B5FA6E6, 0xB93425E5, 0x6DFE410E, 0x9F95C20D, 0x8CC531F9, 0x7EAEB2FA, 0x30E349B1,
+  0xC288CAB2, 0xD1D83946, 0x23B3BA45, 0xF779DEAE, 0x05125DAD, 0x1642AE59, 0xE4292D5A,
+  0xBA3A117E, 0x4851927D, 0x5B016189, 0xA96AE28A, 0x7DA08661, 0x8FCB0562, 0x9C9BF696,
+  0x6EF07595, 0x417B1DBC, 0xB3109EBF, 0xA0406D4B, 0x522BEE48, 0x86E18AA3, 0x748A09A0,
+  0x67DAFA54, 0x95B17957, 0xCBA24573, 0x39C9C670, 0x2A993584, 0xD8F2B687, 0x0C38D26C,
+  0xFE53516F, 0xED03A29B, 0x1F682198, 0x5125DAD3, 0xA34E59D0, 0xB01EAA24, 0x42752927,
+  0x96BF4DCC, 0x64D4CECF, 0x77843D3B, 0x85EFBE38, 0xDBFC821C, 0x2997011F, 0x3AC7F2EB,
+  0xC8AC71E8, 0x1C661503, 0xEE0D9600, 0xFD5D65F4, 0x0F36E6F7, 0x61C69362, 0x93AD1061,
+  0x80FDE395, 0x72966096, 0xA65C047D, 0x5437877E, 0x4767748A, 0xB50CF789, 0xEB1FCBAD,
+  0x197448AE, 0x0A24BB5A, 0xF84F3859, 0x2C855CB2, 0xDEEEDFB1, 0xCDBE2C45, 0x3FD5AF46,
+  0x7198540D, 0x83F3D70E, 0x90A324FA, 0x62C8A7F9, 0xB602C312, 0x44694011, 0x5739B3E5,
+  0xA55230E6, 0xFB410CC2, 0x092A8FC1, 0x1A7A7C35, 0xE811FF36, 0x3CDB9BDD, 0xCEB018DE,
+  0xDDE0EB2A, 0x2F8B6829, 0x82F63B78, 0x709DB87B, 0x63CD4B8F, 0x91A6C88C, 0x456CAC67,
+  0xB7072F64, 0xA457DC90, 0x563C5F93, 0x082F63B7, 0xFA44E0B4, 0xE9141340, 0x1B7F9043,
+  0xCFB5F4A8, 0x3DDE77AB, 0x2E8E845F, 0xDCE5075C, 0x92A8FC17, 0x60C37F14, 0x73938CE0,
+  0x81F80FE3, 0x55326B08, 0xA759E80B, 0xB4091BFF, 0x466298FC, 0x1871A4D8, 0xEA1A27DB,
+  0xF94AD42F, 0x0B21572C, 0xDFEB33C7, 0x2D80B0C4, 0x3ED04330, 0xCCBBC033, 0xA24BB5A6,
+  0x502036A5, 0x4370C551, 0xB11B4652, 0x65D122B9, 0x97BAA1BA, 0x84EA524E, 0x7681D14D,
+  0x2892ED69, 0xDAF96E6A, 0xC9A99D9E, 0x3BC21E9D, 0xEF087A76, 0x1D63F975, 0x0E330A81,
+  0xFC588982, 0xB21572C9, 0x407EF1CA, 0x532E023E, 0xA145813D, 0x758FE5D6, 0x87E466D5,
+  0x94B49521, 0x66DF1622, 0x38CC2A06, 0xCAA7A905, 0xD9F75AF1, 0x2B9CD9F2, 0xFF56BD19,
+  0x0D3D3E1A, 0x1E6DCDEE, 0xEC064EED, 0xC38D26C4, 0x31E6A5C7, 0x22B65633, 0xD0DDD530,
+  0x0417B1DB, 0xF67C32D8, 0xE52CC12C, 0x1747422F, 0x49547E0B, 0xBB3FFD08, 0xA86F0EFC,
+  0x5A048DFF, 0x8ECEE914, 0x7CA56A17, 0x6FF599E3, 0x9D9E1AE0, 0xD3D3E1AB, 0x21B862A8,
+  0x32E8915C, 0xC083125F, 0x144976B4, 0xE622F5B7, 0xF5720643, 0x07198540, 0x590AB964,
+  0xAB613A67, 0xB831C993, 0x4A5A4A90, 0x9E902E7B, 0x6CFBAD78, 0x7FAB5E8C, 0x8DC0DD8F,
+  0xE330A81A, 0x115B2B19, 0x020BD8ED, 0xF0605BEE, 0x24AA3F05, 0xD6C1BC06, 0xC5914FF2,
+  0x37FACCF1, 0x69E9F0D5, 0x9B8273D6, 0x88D28022, 0x7AB90321, 0xAE7367CA, 0x5C18E4C9,
+  0x4F48173D, 0xBD23943E, 0xF36E6F75, 0x0105EC76, 0x12551F82, 0xE03E9C81, 0x34F4F86A,
+  0xC69F7B69, 0xD5CF889D, 0x27A40B9E, 0x79B737BA, 0x8BDCB4B9, 0x988C474D, 0x6AE7C44E,
+  0xBE2DA0A5, 0x4C4623A6, 0x5F16D052, 0xAD7D5351
+};
+#else
+static uint16_t const s_crc16_ccitt_table[16] = {
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+static uint32_t const s_crc32_table[16] = {
+  0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158,
+  0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4,
+  0xA00AE278, 0xBDBDF21C
+};
+static uint32_t const s_crc32c_table[16] = {
+  0x00000000, 0x105EC76F, 0x20BD8EDE, 0x30E349B1, 0x417B1DBC, 0x5125DAD3, 0x61C69362,
+  0x7198540D, 0x82F63B78, 0x92A8FC17, 0xA24BB5A6, 0xB21572C9, 0xC38D26C4, 0xD3D3E1AB,
+  0xE330A81A, 0xF36E6F75
+};
+#endif
+
+// Non-reflected, for CRC-16/CCITT.
+static uint32_t cobs_crc16_sw(uint32_t c, cobs_byte_t const* p, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+#ifdef COBS_SPEED
+    c = ((c << 8) ^ s_crc16_ccitt_table[((c >> 8) ^ p[i]) & 0xFF]) & 0xFFFF;
+#else
+    c = ((c << 4) ^ s_crc16_ccitt_table[((c >> 12) ^ (p[i] >> 4)) & 0xF]) & 0xFFFF;
+    c = ((c << 4) ^ s_crc16_ccitt_table[((c >> 12) ^ p[i]) & 0xF]) & 0xFFFF;
+#endif
+  }
+  return c;
+}
+
+// Reflected, for CRC32 and CRC32C.
+static uint32_t cobs_crc32_sw(uint32_t const* table,
+                              uint32_t c,
+                              cobs_byte_t const* p,
+                              size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+#ifdef COBS_SPEED
+    c = (c >> 8) ^ table[(c ^ p[i]) & 0xFF];
+#else
+    c ^= p[i];
+    c = (c >> 4) ^ table[c & 0xF];
+    c = (c >> 4) ^ table[c & 0xF];
+#endif
+  }
+  return c;
+}
+
+#if defined(COBS_DISPATCH) || (defined(COBS_SSE2) && defined(__SSE4_2__))
+  #define COBS_CRC32C_HW
+  #define COBS_TARGET_SSE42 __attribute__((target("sse4.2")))
+
+typedef uint32_t __attribute__((may_alias, aligned(1))) cobs_u32_unaligned_t;
+  #ifdef __x86_64__
+typedef uint64_t __attribute__((may_alias, aligned(1))) cobs_u64_unaligned_t;
+  #endif
+
+COBS_TARGET_SSE42 static uint32_t cobs_crc32c_sse42(uint32_t c,
+                                                    cobs_byte_t const* p,
+                                                    size_t n) {
+  size_t i = 0;
+  #ifdef __x86_64__
+  uint64_t c64 = c;
+  for (; i + 8 <= n; i += 8) {
+    c64 = __builtin_ia32_crc32di(c64, *(cobs_u64_unaligned_t const*)(void const*)(p + i));
+  }
+  c = (uint32_t)c64;
+  #endif
+  for (; i + 4 <= n; i += 4) {
+    c = __builtin_ia32_crc32si(c, *(cobs_u32_unaligned_t const*)(void const*)(p + i));
+  }
+  for (; i < n; ++i) {
+    c = __builtin_ia32_crc32qi(c, p[i]);
+  }
+  return c;
+}
+
+static inline bool cobs_crc32c_hw(void) {
+  #ifdef COBS_DISPATCH
+  (void)cobs_get_kernel();  // resolves the kernel, and with it s_crc32c_hw
+  return __atomic_load_n(&s_crc32c_hw, __ATOMIC_RELAXED);
+  #else
+  return true;
+  #endif
+}
+#endif
+
+static void cobs_crc_run(cobs_crc_t* crc, cobs_byte_t const* p, size_t n) {
+  switch (crc->kind) {
+    case COBS_CRC_NONE:
+      break;
+
+    case COBS_CRC16_CCITT:
+      crc->state = cobs_crc16_sw(crc->state, p, n);
+      break;
+
+    case COBS_CRC32:
+      crc->state = cobs_crc32_sw(s_crc32_table, crc->state, p, n);
+      break;
+
+    case COBS_CRC32C:
+#ifdef COBS_CRC32C_HW
+      if (cobs_crc32c_hw()) {
+        crc->state = cobs_crc32c_sse42(crc->state, p, n);
+        break;
+      }
+#endif
+      crc->state = cobs_crc32_sw(s_crc32c_table, crc->state, p, n);
+      break;
+  }
+}
+
+cobs_ret_t cobs_crc_begin(cobs_crc_t* crc, cobs_crc_kind_t kind) {
+  if (!crc || (kind > COBS_CRC32C)) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+  crc->kind = kind;
+  crc->state = (kind == COBS_CRC16_CCITT) ? 0xFFFFu : (kind ? 0xFFFFFFFFu : 0u);
+  return COBS_RET_SUCCESS;
+}
+
+cobs_ret_t cobs_crc_update(cobs_crc_t* crc, void const* buf, size_t len) {
+  if (!crc || !buf) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+  cobs_crc_run(crc, (cobs_byte_t const*)buf, len);
+  return COBS_RET_SUCCESS;
+}
+
+uint32_t cobs_crc_value(cobs_crc_t const* crc) {
+  return ((crc->kind == COBS_CRC32) || (crc->kind == COBS_CRC32C)) ? ~crc->state
+                                                                   : crc->state;
+}
+
 cobs_ret_t cobs_encode_tinyframe(void* buf, size_t len) {
   if (!buf || (len < 2)) {
     return COBS_RET_ERR_BAD_ARG;
@@ -14,22 +778,18 @@ cobs_ret_t cobs_encode_tinyframe(void* buf, size_t len) {
   }
 
   size_t patch = 0, cur = 1;
-  while (cur < len - 1) {
-    if (src[cur] == COBS_FRAME_DELIMITER) {
-      size_t const ofs = cur - patch;
-      if (ofs > 255) {
-        return COBS_RET_ERR_BAD_PAYLOAD;
-      }
-      src[patch] = (cobs_byte_t)ofs;
-      patch = cur;
+  for (;;) {
+    cur += cobs_scan(src + cur, len - 1 - cur);
+    size_t const ofs = cur - patch;
+    if (ofs > 255) {
+      return COBS_RET_ERR_BAD_PAYLOAD;
     }
-    ++cur;
-  }
-  size_t const ofs = cur - patch;
-  if (ofs > 255) {
-    return COBS_RET_ERR_BAD_PAYLOAD;
+    src[patch] = (cobs_byte_t)ofs;
+    if (cur == len - 1) {
+      break;
+    }
+    patch = cur++;
   }
-  src[patch] = (cobs_byte_t)ofs;
   src[cur] = 0;
   return COBS_RET_SUCCESS;
 }
@@ -46,10 +806,8 @@ cobs_ret_t cobs_decode_tinyframe(void* buf, size_t const len) {
     if (cur + ofs > len) {
       return COBS_RET_ERR_BAD_PAYLOAD;
     }
-    for (size_t i = 1; i < ofs; ++i) {
-      if (src[cur + i] == 0) {
-        return COBS_RET_ERR_BAD_PAYLOAD;
-      }
+    if (cobs_scan(src + cur + 1, ofs - 1) != ofs - 1) {
+      return COBS_RET_ERR_BAD_PAYLOAD;
     }
     cur += ofs;
   }
@@ -62,6 +820,57 @@ cobs_ret_t cobs_decode_tinyframe(void* buf, size_t const len) {
   return COBS_RET_SUCCESS;
 }
 
+// cobs_encode without the argument checks, folding every block into |crc| (if not null)
+// right after copying it.
+static cobs_ret_t cobs_encode_core(cobs_byte_t const* src,
+                                   size_t dec_len,
+                                   cobs_byte_t* dst,
+                                   size_t enc_max,
+                                   size_t* out_enc_len,
+                                   cobs_crc_t* crc) {
+  size_t src_idx = 0;
+  size_t dst_idx = 1;
+  size_t code_idx = 0;
+
+  for (;;) {
+    // A block is the run of nonzero bytes up to the next zero, capped at 254 bytes.
+    size_t const src_left = dec_len - src_idx;
+    size_t const run = (src_left && !src[src_idx])
+                           ? 0
+                           : cobs_scan(src + src_idx, (src_left < 254) ? src_left : 254);
+
+    // The run must fit, along with the byte that follows it (a code or the delimiter).
+    if (run >= enc_max - dst_idx) {
+      return COBS_RET_ERR_EXHAUSTED;
+    }
+
+    if (run) {
+      cobs_copy(dst + dst_idx, src + src_idx, run);
+    }
+    if (crc) {  // the block, and the zero that ended it if there was one
+      cobs_crc_run(crc, src + src_idx, run + ((run < 254) && (run < dec_len - src_idx)));
+    }
+    dst[code_idx] = (cobs_byte_t)(run + 1);
+    src_idx += run;
+    dst_idx += run;
+
+    // A block that ends with the source is final. If it's a full 0xFF block, no trailing
+    // code byte follows it and the delimiter comes next (correct COBS).
+    if (src_idx == dec_len) {
+      break;
+    }
+
+    if (run < 254) {
+      ++src_idx;  // skip the zero that ended the block
+    }
+    code_idx = dst_idx++;
+  }
+
+  dst[dst_idx++] = COBS_FRAME_DELIMITER;
+  *out_enc_len = dst_idx;
+  return COBS_RET_SUCCESS;
+}
+
 cobs_ret_t cobs_encode(void const* dec,
                        size_t dec_len,
                        void* out_enc,
@@ -73,46 +882,155 @@ cobs_ret_t cobs_encode(void const* dec,
   if (enc_max < 2) {
     return COBS_RET_ERR_BAD_ARG;
   }
+  return cobs_encode_core(
+      (cobs_byte_t const*)dec, dec_len, (cobs_byte_t*)out_enc, enc_max, out_enc_len, NULL);
+}
 
-  cobs_byte_t const* const src = (cobs_byte_t const*)dec;
-  cobs_byte_t* const dst = (cobs_byte_t*)out_enc;
+cobs_ret_t cobs_encode_crc(void const* dec,
+                           size_t dec_len,
+                           void* out_enc,
+                           size_t enc_max,
+                           size_t* out_enc_len,
+                           cobs_crc_t* crc) {
+  if (!dec || !out_enc || !out_enc_len || !crc) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+  if (enc_max < 2) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+
+  cobs_crc_t running = *crc;
+  cobs_ret_t const r = cobs_encode_core((cobs_byte_t const*)dec,
+                                        dec_len,
+                                        (cobs_byte_t*)out_enc,
+                                        enc_max,
+                                        out_enc_len,
+                                        &running);
+  if (r == COBS_RET_SUCCESS) {
+    *crc = running;
+  }
+  return r;
+}
+
+cobs_ret_t cobs_encoded_len(void const* dec, size_t dec_len, size_t* out_enc_len) {
+  if (!dec || !out_enc_len) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
 
+  // Only the zeros matter. A stretch of |n| nonzero bytes ended by a zero is |n / 254|
+  // full blocks followed by one the zero closes, the zero itself becoming that block's
+  // code byte. The stretch after the last zero has nothing to close it, so a full block
+  // there needs no empty block after it, but even an empty stretch needs its code byte.
+  cobs_byte_t const* const src = (cobs_byte_t const*)dec;
+  size_t enc_len = 1;  // the delimiter
   size_t src_idx = 0;
+  for (;;) {
+    size_t const n = cobs_scan(src + src_idx, dec_len - src_idx);
+    src_idx += n;
+    if (src_idx == dec_len) {
+      enc_len += n ? (n + (n / 254) + ((n % 254) != 0)) : 1;
+      break;
+    }
+    enc_len += n + (n / 254) + 1;
+    ++src_idx;
+  }
+
+  *out_enc_len = enc_len;
+  return COBS_RET_SUCCESS;
+}
+
+cobs_ret_t cobs_encode_inplace(void* buf,
+                               size_t dec_len,
+                               size_t buf_max,
+                               size_t* out_enc_len) {
+  if (!buf || !out_enc_len) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+  // COBS_ENCODE_MAX(dec_len) - dec_len, without overflowing on enormous lengths.
+  size_t const overhead = 1 + (dec_len / 254) + ((dec_len % 254) != 0) + (dec_len == 0);
+  if ((dec_len > buf_max) || (buf_max - dec_len < overhead)) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+
+  // Shift the payload to the end of |buf|, tail first, in chunks no longer than the
+  // distance moved so that each chunk's copy doesn't overlap itself.
+  cobs_byte_t* const p = (cobs_byte_t*)buf;
+  size_t const shift = buf_max - dec_len;
+  for (size_t left = dec_len; left;) {
+    size_t const n = (left < shift) ? left : shift;
+    left -= n;
+    cobs_copy(p + left + shift, p + left, n);
+  }
+
+  // Encoding then writes at most one code byte more than it has read, and the shift is
+  // bigger than the number of code bytes, so the output always trails the unread input.
+  return cobs_encode(p + shift, dec_len, p, buf_max, out_enc_len);
+}
+
+cobs_ret_t cobs_encode_gather(cobs_src_seg_t const* segs,
+                              size_t seg_count,
+                              void* out_enc,
+                              size_t enc_max,
+                              size_t* out_enc_len) {
+  if (!segs || !out_enc || !out_enc_len) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+  if (enc_max < 2) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+  for (size_t i = 0; i < seg_count; ++i) {
+    if (!segs[i].buf && segs[i].len) {
+      return COBS_RET_ERR_BAD_ARG;
+    }
+  }
+
+  cobs_byte_t* const dst = (cobs_byte_t*)out_enc;
+  size_t seg = 0, seg_idx = 0;
   size_t dst_idx = 1;
   size_t code_idx = 0;
-  unsigned code = 1;
+  size_t run = 0;  // bytes in the current block; blocks can straddle segments
 
-  while (src_idx < dec_len) {
-    if (dst_idx >= enc_max) {
-      return COBS_RET_ERR_EXHAUSTED;
+  // Like cobs_encode, but a block's run of nonzero bytes is gathered piece by piece, and a
+  // block only ends once the next byte is known. There's always room for the byte after
+  // the last one written, either the next block's code or the delimiter.
+  for (;;) {
+    while ((seg < seg_count) && (seg_idx == segs[seg].len)) {
+      ++seg;
+      seg_idx = 0;
     }
-
-    cobs_byte_t const byte = src[src_idx];
-    if (byte) {
-      dst[dst_idx] = byte;
-      ++dst_idx;
-      ++code;
+    if (seg == seg_count) {
+      break;
     }
 
-    if ((byte == 0) || (code == 0xFF)) {
-      dst[code_idx] = (cobs_byte_t)code;
-      code_idx = dst_idx;
-      code = 1;
+    cobs_byte_t const* const src = (cobs_byte_t const*)segs[seg].buf + seg_idx;
+    size_t const src_left = segs[seg].len - seg_idx;
 
-      // Advance past code placeholder unless this is the last source byte
-      // AND code==0xFF. In that case, code_idx == dst_idx, and the final
-      // code byte will be overwritten by the delimiter (correct COBS).
-      if ((byte == 0) || (src_idx + 1 < dec_len)) {
-        ++dst_idx;
+    if ((run == 254) || !*src) {
+      // A full 0xFF block is followed by more data, or a zero ends the block.
+      if (dst_idx + 1 >= enc_max) {
+        return COBS_RET_ERR_EXHAUSTED;
+      }
+      dst[code_idx] = (cobs_byte_t)(run + 1);
+      code_idx = dst_idx++;
+      if (run < 254) {
+        ++seg_idx;  // skip the zero that ended the block
       }
+      run = 0;
+      continue;
     }
-    ++src_idx;
-  }
 
-  dst[code_idx] = (cobs_byte_t)code;
-  if (dst_idx >= enc_max) {
-    return COBS_RET_ERR_EXHAUSTED;
+    size_t const n = cobs_scan(src, (src_left < 254 - run) ? src_left : 254 - run);
+    if (n >= enc_max - dst_idx) {
+      return COBS_RET_ERR_EXHAUSTED;
+    }
+    cobs_copy(dst + dst_idx, src, n);
+    dst_idx += n;
+    seg_idx += n;
+    run += n;
   }
+
+  // A final full 0xFF block has no trailing code byte, as in cobs_encode.
+  dst[code_idx] = (cobs_byte_t)(run + 1);
   dst[dst_idx++] = COBS_FRAME_DELIMITER;
   *out_enc_len = dst_idx;
   return COBS_RET_SUCCESS;
@@ -166,6 +1084,8 @@ cobs_ret_t cobs_encode_inc(cobs_enc_ctx_t* ctx,
   size_t const dst_max = args->enc_dst_max;
   size_t src_idx = 0;
   size_t dst_idx = 0;
+  cobs_crc_t* const crc = (args->crc && args->crc->kind) ? args->crc : NULL;
+  size_t crc_idx = 0;  // source bytes before this are already in the CRC
 
   cobs_byte_t* const buf = ctx->buf;
   unsigned code = ctx->code;
@@ -189,23 +1109,49 @@ cobs_ret_t cobs_encode_inc(cobs_enc_ctx_t* ctx,
       goto done;
     }
 
-    cobs_byte_t const byte = src[src_idx];
-    if (byte) {
-      buf[buf_len++] = byte;
-      ++code;
-    }
+    // Take the next stretch of nonzero bytes that fits in the open block, whose bytes so
+    // far are buf[1, buf_len). It ends the block if it stops at a zero or fills it.
+    size_t const src_left = src_max - src_idx;
+    size_t const room = 0xFFu - code;
+    size_t const n = cobs_scan(src + src_idx, (src_left < room) ? src_left : room);
+    bool const zero = (n < room) && (n < src_left);
+    bool const ends = zero || (n == room);
 
-    if ((byte == 0) || (code == 0xFF)) {
+    if ((buf_len == 1) && ends && (n < dst_max - dst_idx)) {
+      // The whole block is in |src| and fits in |dst|, so skip the work buffer: write it
+      // out directly, behind its code byte.
+      code += (unsigned)n;
+      dst[dst_idx] = (cobs_byte_t)code;
+      cobs_copy(dst + dst_idx + 1, src + src_idx, n);
+      dst_idx += n + 1;
+      src_idx += n + zero;
+      ctx->prev_was_ff = (code == 0xFF);
+      code = 1;
+    } else {
+      // The block straddles calls or |dst| is short, so stage it and flush what fits.
+      cobs_copy(buf + buf_len, src + src_idx, n);
+      buf_len += (unsigned)n;
+      code += (unsigned)n;
+      src_idx += n + zero;
+      if (!ends) {
+        continue;
+      }
       ctx->prev_was_ff = (code == 0xFF);
       buf[0] = (cobs_byte_t)code;
       ctx->flush_pos = 0;
       state = COBS_ENCODE_FLUSHING;
     }
 
-    ++src_idx;
+    if (crc) {
+      cobs_crc_run(crc, src + crc_idx, src_idx - crc_idx);
+      crc_idx = src_idx;
+    }
   }
 
 done:
+  if (crc) {
+    cobs_crc_run(crc, src + crc_idx, src_idx - crc_idx);
+  }
   ctx->state = state;
   ctx->code = (uint8_t)code;
   ctx->buf_len = (uint8_t)buf_len;
@@ -315,31 +1261,84 @@ cobs_ret_t cobs_decode(void const* enc,
   return decode_complete ? COBS_RET_SUCCESS : COBS_RET_ERR_EXHAUSTED;
 }
 
-cobs_ret_t cobs_decode_inc_begin(cobs_decode_inc_ctx_t* ctx) {
-  if (!ctx) {
+cobs_ret_t cobs_validate(void const* enc,
+                         size_t enc_len,
+                         size_t* out_dec_len,
+                         size_t* out_err_ofs) {
+  if (!enc || !out_dec_len || !out_err_ofs) {
     return COBS_RET_ERR_BAD_ARG;
   }
-  ctx->state = COBS_DECODE_READ_CODE;
+  if (enc_len < 2) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+
+  // Hop from code byte to code byte, scanning each block for zeros but copying nothing.
+  cobs_byte_t const* const src = (cobs_byte_t const*)enc;
+  size_t src_idx = 0, dec_len = 0;
+  for (;;) {
+    size_t const code = src[src_idx];
+    if (!code) {
+      *out_err_ofs = src_idx;
+      return COBS_RET_ERR_BAD_PAYLOAD;
+    }
+
+    // Check as much of the block as there is, so a zero inside it wins over truncation.
+    size_t const left = enc_len - src_idx - 1;
+    size_t const run = (code - 1 < left) ? code - 1 : left;
+    size_t const zero = cobs_scan(src + src_idx + 1, run);
+    if (zero != run) {
+      *out_err_ofs = src_idx + 1 + zero;
+      return COBS_RET_ERR_BAD_PAYLOAD;
+    }
+    if (code - 1 >= left) {  // no room for the byte after the block
+      *out_err_ofs = enc_len;
+      return COBS_RET_ERR_BAD_PAYLOAD;
+    }
+
+    src_idx += code;
+    dec_len += code - 1;
+    if (!src[src_idx]) {
+      break;
+    }
+    dec_len += (code != 0xFF);  // the zero that ended the block
+  }
+
+  *out_dec_len = dec_len;
   return COBS_RET_SUCCESS;
 }
 
-cobs_ret_t cobs_decode_inc(cobs_decode_inc_ctx_t* ctx,
-                           cobs_decode_inc_args_t const* args,
-                           size_t* out_enc_src_len,
-                           size_t* out_dec_dst_len,
-                           bool* out_decode_complete) {
-  if (!ctx || !args || !out_enc_src_len || !out_dec_dst_len || !out_decode_complete ||
-      !args->dec_dst || !args->enc_src) {
+cobs_ret_t cobs_decoded_len(void const* enc, size_t enc_len, size_t* out_dec_len) {
+  size_t err_ofs;
+  return cobs_validate(enc, enc_len, out_dec_len, &err_ofs);
+}
+
+cobs_ret_t cobs_decode_inc_begin(cobs_decode_inc_ctx_t* ctx) {
+  if (!ctx) {
     return COBS_RET_ERR_BAD_ARG;
   }
+  ctx->state = COBS_DECODE_READ_CODE;
+  ctx->block = 0;
+  ctx->code = 0;
+  return COBS_RET_SUCCESS;
+}
 
+// The body of cobs_decode_inc, minus argument validation, shared with the batch decoder.
+// The decoded bytes are folded into |crc| unless it's null.
+static cobs_ret_t cobs_decode_inc_core(cobs_decode_inc_ctx_t* ctx,
+                                       cobs_byte_t const* src_b,
+                                       size_t src_max,
+                                       cobs_byte_t* dst_b,
+                                       size_t dst_max,
+                                       cobs_crc_t* crc,
+                                       size_t* out_enc_src_len,
+                                       size_t* out_dec_dst_len,
+                                       bool* out_decode_complete) {
   bool decode_complete = false;
   size_t src_idx = 0, dst_idx = 0;
-
-  size_t const src_max = args->enc_src_max;
-  size_t const dst_max = args->dec_dst_max;
-  cobs_byte_t const* src_b = (cobs_byte_t const*)args->enc_src;
-  cobs_byte_t* dst_b = (cobs_byte_t*)args->dec_dst;
+  size_t crc_idx = 0;  // decoded bytes before this are already in the CRC
+  if (crc && !crc->kind) {
+    crc = NULL;
+  }
   unsigned block = ctx->block, code = ctx->code;
   enum cobs_decode_inc_state state = ctx->state;
 
@@ -347,6 +1346,9 @@ cobs_ret_t cobs_decode_inc(cobs_decode_inc_ctx_t* ctx,
     switch (state) {
       case COBS_DECODE_READ_CODE: {
         block = code = src_b[src_idx++];
+        if (!code) {  // a delimiter where a frame should start
+          return COBS_RET_ERR_BAD_PAYLOAD;
+        }
         state = COBS_DECODE_RUN;
       } break;
 
@@ -366,6 +1368,41 @@ cobs_ret_t cobs_decode_inc(cobs_decode_inc_ctx_t* ctx,
       } break;
 
       case COBS_DECODE_RUN: {
+        // Fast path: while the rest of the block fits in both buffers, copy it in one
+        // shot, stopping at any zero byte, then step over the next code byte inline. A run
+        // of whole blocks decodes without going back through the switch.
+        for (;;) {
+          size_t const run = block - 1;
+          if ((run > src_max - src_idx) || (run > dst_max - dst_idx)) {
+            break;
+          }
+          if (run) {
+            if (cobs_copy_run(dst_b + dst_idx, src_b + src_idx, run) != run) {
+              return COBS_RET_ERR_BAD_PAYLOAD;
+            }
+            src_idx += run;
+            dst_idx += run;
+          }
+          block = 1;
+
+          // What COBS_DECODE_FINISH_RUN and COBS_DECODE_READ_CODE would do, leaving the
+          // delimiter and a full |dst| to them.
+          if ((src_idx >= src_max) || !src_b[src_idx]) {
+            break;
+          }
+          if (code != 0xFF) {
+            if (dst_idx >= dst_max) {
+              break;
+            }
+            dst_b[dst_idx++] = 0;
+          }
+          if (crc) {
+            cobs_crc_run(crc, dst_b + crc_idx, dst_idx - crc_idx);
+            crc_idx = dst_idx;
+          }
+          block = code = src_b[src_idx++];
+        }
+
         while (block - 1) {
           if ((src_idx >= src_max) || (dst_idx >= dst_max)) {
             goto done;
@@ -380,11 +1417,19 @@ cobs_ret_t cobs_decode_inc(cobs_decode_inc_ctx_t* ctx,
           dst_b[dst_idx++] = b;
         }
         state = COBS_DECODE_FINISH_RUN;
+
+        if (crc) {  // fold in the block while it's still in L1
+          cobs_crc_run(crc, dst_b + crc_idx, dst_idx - crc_idx);
+          crc_idx = dst_idx;
+        }
       } break;
     }
   }
 
 done:
+  if (crc) {
+    cobs_crc_run(crc, dst_b + crc_idx, dst_idx - crc_idx);
+  }
   ctx->state = state;
   ctx->code = (uint8_t)code;
   ctx->block = (uint8_t)block;
@@ -393,3 +1438,300 @@ done:
   *out_decode_complete = decode_complete;
   return COBS_RET_SUCCESS;
 }
+
+cobs_ret_t cobs_decode_inc(cobs_decode_inc_ctx_t* ctx,
+                           cobs_decode_inc_args_t const* args,
+                           size_t* out_enc_src_len,
+                           size_t* out_dec_dst_len,
+                           bool* out_decode_complete) {
+  if (!ctx || !args || !out_enc_src_len || !out_dec_dst_len || !out_decode_complete ||
+      !args->dec_dst || !args->enc_src) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+  return cobs_decode_inc_core(ctx,
+                              (cobs_byte_t const*)args->enc_src,
+                              args->enc_src_max,
+                              (cobs_byte_t*)args->dec_dst,
+                              args->dec_dst_max,
+                              args->crc,
+                              out_enc_src_len,
+                              out_dec_dst_len,
+                              out_decode_complete);
+}
+
+static inline bool cobs_ring_valid(cobs_ring_t const* ring) {
+  return ring && ring->buf && (ring->head < ring->cap) && (ring->tail < ring->cap);
+}
+
+cobs_ret_t cobs_decode_inc_ring(cobs_decode_inc_ctx_t* ctx,
+                                cobs_decode_ring_args_t const* args,
+                                size_t* out_dec_dst_len,
+                                bool* out_decode_complete) {
+  if (!ctx || !args || !out_dec_dst_len || !out_decode_complete ||
+      !cobs_ring_valid(args->enc_src)) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+  cobs_ring_t* const src = args->enc_src;
+  cobs_ring_t* const ring = args->dec_ring;
+  if (ring ? !cobs_ring_valid(ring) : !args->dec_dst) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+
+  // Decode one contiguous stretch of each at a time. Each step runs until the source or
+  // destination stretch ends at its wrap point, so a frame takes at most a few steps.
+  cobs_byte_t* const src_b = (cobs_byte_t*)src->buf;
+  size_t written = 0;
+  bool complete = false;
+  for (;;) {
+    size_t const src_max = ((src->tail >= src->head) ? src->tail : src->cap) - src->head;
+    if (!src_max) {
+      break;
+    }
+
+    cobs_byte_t* dst_b;
+    size_t dst_max;
+    if (ring) {  // free space runs up to the byte before |head|
+      dst_b = (cobs_byte_t*)ring->buf + ring->tail;
+      dst_max = (ring->head > ring->tail) ? (ring->head - ring->tail - 1)
+                                          : (ring->cap - ring->tail - !ring->head);
+    } else {
+      dst_b = (cobs_byte_t*)args->dec_dst + written;
+      dst_max = args->dec_dst_max - written;
+    }
+
+    size_t src_len, dst_len;
+    cobs_ret_t const r = cobs_decode_inc_core(ctx,
+                                              src_b + src->head,
+                                              src_max,
+                                              dst_b,
+                                              dst_max,
+                                              args->crc,
+                                              &src_len,
+                                              &dst_len,
+                                              &complete);
+    if (r != COBS_RET_SUCCESS) {
+      return r;
+    }
+
+    src->head += src_len + complete;  // the core stops on the delimiter without reading it
+    if (src->head == src->cap) {
+      src->head = 0;
+    }
+    if (ring) {
+      ring->tail += dst_len;
+      if (ring->tail == ring->cap) {
+        ring->tail = 0;
+      }
+    }
+    written += dst_len;
+
+    if (complete || (!src_len && !dst_len)) {  // done, or out of room
+      break;
+    }
+  }
+
+  *out_dec_dst_len = written;
+  *out_decode_complete = complete;
+  return COBS_RET_SUCCESS;
+}
+
+cobs_ret_t cobs_decode_crc(void const* enc,
+                           size_t enc_len,
+                           void* out_dec,
+                           size_t dec_max,
+                           size_t* out_dec_len,
+                           cobs_crc_t* crc) {
+  if (!enc || !out_dec || !out_dec_len || !crc) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+  if (enc_len < 2) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+
+  cobs_decode_inc_ctx_t ctx = { .state = COBS_DECODE_READ_CODE };
+  cobs_crc_t running = *crc;
+  size_t src_len;
+  bool complete;
+  cobs_ret_t const r = cobs_decode_inc_core(&ctx,
+                                            (cobs_byte_t const*)enc,
+                                            enc_len,
+                                            (cobs_byte_t*)out_dec,
+                                            dec_max,
+                                            &running,
+                                            &src_len,
+                                            out_dec_len,
+                                            &complete);
+  if (r != COBS_RET_SUCCESS) {
+    return r;
+  }
+  if (!complete) {
+    return COBS_RET_ERR_EXHAUSTED;
+  }
+  *crc = running;
+  return COBS_RET_SUCCESS;
+}
+
+cobs_ret_t cobs_decode_inplace(void* buf, size_t enc_len, size_t* out_dec_len) {
+  if (!buf || !out_dec_len) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+  if (enc_len < 2) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+
+  // The code byte puts the write position at least one byte behind the read position
+  // from the start, and it never catches up, so the copy kernels' leftward overlap rule
+  // holds. Running out of source is the only way not to finish, so that's a bad frame.
+  cobs_decode_inc_ctx_t ctx = { .state = COBS_DECODE_READ_CODE };
+  size_t src_len, dec_len;
+  bool complete;
+  cobs_ret_t const r = cobs_decode_inc_core(&ctx,
+                                            (cobs_byte_t const*)buf,
+                                            enc_len,
+                                            (cobs_byte_t*)buf,
+                                            enc_len,
+                                            NULL,
+                                            &src_len,
+                                            &dec_len,
+                                            &complete);
+  if (r != COBS_RET_SUCCESS) {
+    return r;
+  }
+  if (!complete) {
+    return COBS_RET_ERR_BAD_PAYLOAD;
+  }
+  *out_dec_len = dec_len;
+  return COBS_RET_SUCCESS;
+}
+
+cobs_ret_t cobs_decode_scatter(void const* enc,
+                               size_t enc_len,
+                               cobs_dst_seg_t const* segs,
+                               size_t seg_count,
+                               size_t* out_dec_len) {
+  if (!enc || !segs || !out_dec_len) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+  if (enc_len < 2) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+  for (size_t i = 0; i < seg_count; ++i) {
+    if (!segs[i].buf && segs[i].len) {
+      return COBS_RET_ERR_BAD_ARG;
+    }
+  }
+
+  cobs_byte_t const* const src_b = (cobs_byte_t const*)enc;
+  cobs_decode_inc_ctx_t ctx = { .state = COBS_DECODE_READ_CODE };
+  size_t src_idx = 0, dec_len = 0;
+  cobs_byte_t spare;  // the frame may still end once the segments run out
+
+  // Resume the same decoder in each segment in turn, so blocks and the zeros between them
+  // can straddle segment boundaries.
+  for (size_t seg = 0;; ++seg) {
+    bool const last = (seg == seg_count);
+    size_t const dst_max = last ? 0 : segs[seg].len;
+    if (!dst_max && !last) {
+      continue;
+    }
+
+    size_t src_len, dst_len;
+    bool complete;
+    cobs_ret_t const r = cobs_decode_inc_core(&ctx,
+                                              src_b + src_idx,
+                                              enc_len - src_idx,
+                                              last ? &spare : (cobs_byte_t*)segs[seg].buf,
+                                              dst_max,
+                                              NULL,
+                                              &src_len,
+                                              &dst_len,
+                                              &complete);
+    if (r != COBS_RET_SUCCESS) {
+      return r;
+    }
+    src_idx += src_len;
+    dec_len += dst_len;
+
+    // Stopping short of a full segment means the frame ended without a delimiter.
+    if (complete || last || (dst_len < dst_max)) {
+      *out_dec_len = dec_len;
+      return complete ? COBS_RET_SUCCESS : COBS_RET_ERR_EXHAUSTED;
+    }
+  }
+}
+
+cobs_ret_t cobs_decode_frames(void const* enc,
+                              size_t enc_len,
+                              void* out_dec,
+                              size_t dec_max,
+                              cobs_frame_t* out_frames,
+                              size_t frames_max,
+                              size_t* out_frame_count,
+                              size_t* out_enc_tail_len) {
+  if (!enc || !out_dec || !out_frames || !out_frame_count || !out_enc_tail_len) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+
+  cobs_byte_t const* const src_b = (cobs_byte_t const*)enc;
+  cobs_byte_t* const dst_b = (cobs_byte_t*)out_dec;
+  size_t src_idx = 0, dst_idx = 0, n = 0;
+  bool stalled = false;  // a complete frame remains but there's no room for it
+
+  while (src_idx < enc_len) {
+    // Find the frame's delimiter first; without one, the frame is still arriving.
+    size_t const left = enc_len - src_idx;
+    size_t const frame_len = cobs_scan(src_b + src_idx, left);
+    if (frame_len == left) {
+      break;
+    }
+    if (n == frames_max) {
+      stalled = true;
+      break;
+    }
+
+    cobs_frame_t* const f = &out_frames[n];
+    f->dec_ofs = dst_idx;
+    f->dec_len = 0;
+    f->status = COBS_RET_ERR_BAD_PAYLOAD;
+
+    if (frame_len) {  // otherwise it's empty (back-to-back delimiters)
+      // A frame never decodes to more than |frame_len| - 1 bytes.
+      size_t const room = dec_max - dst_idx;
+      size_t const dst_max = (frame_len - 1 < room) ? frame_len - 1 : room;
+      cobs_decode_inc_ctx_t ctx = { .state = COBS_DECODE_READ_CODE };
+      size_t src_len, dst_len;
+      bool complete;
+      cobs_ret_t const r = cobs_decode_inc_core(&ctx,
+                                                src_b + src_idx,
+                                                frame_len + 1,
+                                                dst_b + dst_idx,
+                                                dst_max,
+                                                NULL,
+                                                &src_len,
+                                                &dst_len,
+                                                &complete);
+
+      if ((r == COBS_RET_SUCCESS) && !complete) {
+        // The output ran out first. Only a frame that's well-formed waits for more room;
+        // a bad one is consumed like any other.
+        size_t dec_len, err_ofs;
+        if (cobs_validate(src_b + src_idx, frame_len + 1, &dec_len, &err_ofs) ==
+            COBS_RET_SUCCESS) {
+          stalled = true;
+          break;
+        }
+      } else if (r == COBS_RET_SUCCESS) {
+        f->status = COBS_RET_SUCCESS;
+        f->dec_len = dst_len;
+        dst_idx += dst_len;
+      }
+    }
+
+    src_idx += frame_len + 1;
+    ++n;
+  }
+
+  *out_frame_count = n;
+  *out_enc_tail_len = enc_len - src_idx;
+  return (stalled && !n) ? COBS_RET_ERR_EXHAUSTED : COBS_RET_SUCCESS;
+}
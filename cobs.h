@@ -109,6 +109,82 @@ cobs_ret_t cobs_decode(void const* enc,
                        size_t dec_max,
                        size_t* out_dec_len);
 
+// cobs_decoded_len
+//
+// Compute the exact length in bytes that cobs_decode would produce for the |enc_len|
+// encoded bytes in |enc|, storing it in |out_dec_len|, without decoding. Only the chain
+// of code bytes is walked, along with a kernel scan of each block for stray zeros, so
+// this also fully checks the frame: cobs_decode into a buffer of |out_dec_len| bytes
+// succeeds if and only if this does. Returns COBS_RET_SUCCESS on success.
+//
+// If any of the input pointers are null, or if any of the lengths are invalid, the
+// function will fail with COBS_RET_ERR_BAD_ARG.
+//
+// If |enc| is not a valid frame, including one cut short before its delimiter, the
+// function will fail with COBS_RET_ERR_BAD_PAYLOAD.
+cobs_ret_t cobs_decoded_len(void const* enc, size_t enc_len, size_t* out_dec_len);
+
+// cobs_validate
+//
+// Like cobs_decoded_len, but when |enc| is not a valid frame, also stores in
+// |out_err_ofs| the offset into |enc| of the first byte that makes it invalid: a zero
+// where a code byte or block data should be, or |enc_len| if the delimiter is missing.
+cobs_ret_t cobs_validate(void const* enc,
+                         size_t enc_len,
+                         size_t* out_dec_len,
+                         size_t* out_err_ofs);
+
+// cobs_encoded_len
+//
+// Compute the exact length in bytes, delimiter included, that cobs_encode would produce
+// for the |dec_len| bytes at |dec|, storing it in |out_enc_len|. Nothing is written.
+// Unlike COBS_ENCODE_MAX, which is a bound, this reads the payload: it scans for zeros
+// with the same kernels as cobs_encode, so it runs at roughly memchr speed. Returns
+// COBS_RET_SUCCESS on success.
+//
+// If any of the input pointers are null, the function will fail with
+// COBS_RET_ERR_BAD_ARG.
+cobs_ret_t cobs_encoded_len(void const* dec, size_t dec_len, size_t* out_enc_len);
+
+// cobs_encode_inplace
+//
+// Encode in-place the |dec_len| bytes at the start of |buf|, a buffer of |buf_max|
+// bytes, storing the encoded length in |out_enc_len|. The output is byte-identical to
+// cobs_encode's and starts at the start of |buf|. Returns COBS_RET_SUCCESS on successful
+// encoding.
+//
+// Unlike cobs_encode_tinyframe, payloads of any length and contents can be encoded, and
+// no sentinel bytes are needed. Instead, |buf_max| must be at least
+// COBS_ENCODE_MAX(|dec_len|), which guarantees success. The payload is shifted to the
+// end of |buf| and then encoded forward, so this costs one extra pass over the payload.
+//
+// If any of the input pointers are null, or if |buf_max| is less than
+// COBS_ENCODE_MAX(|dec_len|), the function will fail with COBS_RET_ERR_BAD_ARG.
+//
+// The bytes of |buf| past the encoded length are left indeterminate.
+cobs_ret_t cobs_encode_inplace(void* buf,
+                               size_t dec_len,
+                               size_t buf_max,
+                               size_t* out_enc_len);
+
+// cobs_decode_inplace
+//
+// Decode the |enc_len| encoded bytes in |buf| in place, storing the decoded length in
+// |out_dec_len|. Decoding never grows a frame, so the decoded bytes are compacted leftward
+// to the start of |buf|, with no second buffer needed. Returns COBS_RET_SUCCESS on
+// successful decoding. Unlike the tinyframe API, |buf| holds a standard frame of any
+// length, as produced by cobs_encode.
+//
+// If any of the input pointers are null, or if any of the lengths are invalid, the
+// function will fail with COBS_RET_ERR_BAD_ARG.
+//
+// If |buf| starts with a 0 byte, or does not contain a 0 byte delimiter, the function
+// will fail with COBS_RET_ERR_BAD_PAYLOAD.
+//
+// The bytes of |buf| past the decoded length are left indeterminate, as is all of |buf|
+// if the function fails.
+cobs_ret_t cobs_decode_inplace(void* buf, size_t enc_len, size_t* out_dec_len);
+
 // cobs_encode
 //
 // Encode |dec_len| decoded bytes from |dec| into |out_enc|, storing the encoded length in
@@ -125,6 +201,119 @@ cobs_ret_t cobs_encode(void const* dec,
                        size_t enc_max,
                        size_t* out_enc_len);
 
+// Scatter-gather API
+
+typedef struct cobs_src_seg {
+  void const* buf;  // may be null if |len| is 0
+  size_t len;
+} cobs_src_seg_t;
+
+// cobs_encode_gather
+//
+// Encode the |seg_count| segments in |segs|, concatenated, as a single frame into
+// |out_enc|, storing the encoded length in |out_enc_len|. This produces the same bytes as
+// cobs_encode would on a buffer holding all of the segments back to back, without needing
+// that buffer, so e.g. a header, payload and trailer can be framed without copying them
+// together first. Returns COBS_RET_SUCCESS on successful encoding.
+//
+// If any of the input pointers are null, if a segment with a nonzero length has a null
+// |buf|, or if any of the lengths are invalid, the function will fail with
+// COBS_RET_ERR_BAD_ARG.
+//
+// If the encoding exceeds |enc_max| bytes, the function will fail with
+// COBS_RET_ERR_EXHAUSTED.
+cobs_ret_t cobs_encode_gather(cobs_src_seg_t const* segs,
+                              size_t seg_count,
+                              void* out_enc,
+                              size_t enc_max,
+                              size_t* out_enc_len);
+
+typedef struct cobs_dst_seg {
+  void* buf;  // may be null if |len| is 0
+  size_t len;
+} cobs_dst_seg_t;
+
+// cobs_decode_scatter
+//
+// Decode |enc_len| encoded bytes from |enc| into the |seg_count| segments in |segs|,
+// filling each segment completely before moving on to the next, and storing the decoded
+// length in |out_dec_len|. This behaves exactly like cobs_decode into one buffer as large
+// as all of the segments together, so e.g. a fixed-size header and the body that follows
+// it can be decoded into separate buffers without copying them out of a scratch buffer.
+// Returns COBS_RET_SUCCESS on successful decoding.
+//
+// If any of the input pointers are null, if a segment with a nonzero length has a null
+// |buf|, or if any of the lengths are invalid, the function will fail with
+// COBS_RET_ERR_BAD_ARG.
+//
+// If |enc| starts with a 0 byte, or does not end with a 0 byte, the function will fail
+// with COBS_RET_ERR_BAD_PAYLOAD.
+//
+// If the decoding exceeds the combined length of the segments, the function will fail
+// with COBS_RET_ERR_EXHAUSTED.
+cobs_ret_t cobs_decode_scatter(void const* enc,
+                               size_t enc_len,
+                               cobs_dst_seg_t const* segs,
+                               size_t seg_count,
+                               size_t* out_dec_len);
+
+// CRC API
+
+typedef enum {
+  COBS_CRC_NONE = 0,
+  COBS_CRC16_CCITT,  // CRC-16/CCITT-FALSE: poly 0x1021, init 0xFFFF, not reflected
+  COBS_CRC32,        // zlib/Ethernet CRC-32: poly 0x04C11DB7, reflected
+  COBS_CRC32C        // Castagnoli CRC-32C: poly 0x1EDC6F41, reflected
+} cobs_crc_kind_t;
+
+typedef struct cobs_crc {
+  cobs_crc_kind_t kind;
+  uint32_t state;
+} cobs_crc_t;
+
+// cobs_crc_begin
+//
+// Start a CRC of type |kind| in |crc|. COBS_CRC_NONE computes nothing.
+//
+// If |crc| is null or |kind| is unknown, returns COBS_RET_ERR_BAD_ARG.
+cobs_ret_t cobs_crc_begin(cobs_crc_t* crc, cobs_crc_kind_t kind);
+
+// cobs_crc_update
+//
+// Fold |len| bytes from |buf| into |crc|, for data that doesn't pass through the encoder
+// or decoder (a header that's sent separately, say).
+//
+// If any of the input pointers are null, returns COBS_RET_ERR_BAD_ARG.
+cobs_ret_t cobs_crc_update(cobs_crc_t* crc, void const* buf, size_t len);
+
+// cobs_crc_value
+//
+// Returns the CRC of everything folded into |crc| so far, with the final XOR applied.
+// |crc| is left as is, so more data can still be added.
+uint32_t cobs_crc_value(cobs_crc_t const* crc);
+
+// cobs_encode_crc, cobs_decode_crc
+//
+// The same as cobs_encode and cobs_decode, but also fold the decoded bytes into |crc|, a
+// block at a time as they're copied, instead of in a separate pass. |crc| must have been
+// started with cobs_crc_begin, and is only updated if the function succeeds. Returns
+// COBS_RET_ERR_BAD_ARG if |crc| is null.
+//
+// In COBS_SPEED builds on x86, CRC32C uses the SSE4.2 crc32 instruction when the CPU has
+// it, unless the scalar or SWAR kernel was selected with cobs_set_kernel.
+cobs_ret_t cobs_encode_crc(void const* dec,
+                           size_t dec_len,
+                           void* out_enc,
+                           size_t enc_max,
+                           size_t* out_enc_len,
+                           cobs_crc_t* crc);
+cobs_ret_t cobs_decode_crc(void const* enc,
+                           size_t enc_len,
+                           void* out_dec,
+                           size_t dec_max,
+                           size_t* out_dec_len,
+                           cobs_crc_t* crc);
+
 // Incremental encoding API
 
 typedef struct cobs_enc_ctx {
@@ -147,6 +336,7 @@ typedef struct cobs_encode_inc_args {
   void* enc_dst;
   size_t dec_src_max;
   size_t enc_dst_max;
+  cobs_crc_t* crc;  // if not null, the source bytes consumed are folded into it
 } cobs_encode_inc_args_t;
 
 // cobs_encode_inc_begin
@@ -155,6 +345,9 @@ typedef struct cobs_encode_inc_args {
 // |buf| is a user-provided work buffer that must be at least 255 bytes and must remain
 // valid until cobs_encode_inc_end completes.
 //
+// To also compute a CRC of the source bytes as they're consumed, start one with
+// cobs_crc_begin and pass it as |args->crc| to every cobs_encode_inc call.
+//
 // If |ctx| or |buf| are null, or if |buf_max| < 255, returns COBS_RET_ERR_BAD_ARG.
 cobs_ret_t cobs_encode_inc_begin(cobs_enc_ctx_t* ctx, void* buf, size_t buf_max);
 
@@ -164,6 +357,10 @@ cobs_ret_t cobs_encode_inc_begin(cobs_enc_ctx_t* ctx, void* buf, size_t buf_max)
 // |args->enc_dst|. The number of source bytes consumed is written to |out_dec_src_len|
 // and the number of output bytes written is written to |out_enc_dst_len|.
 //
+// A block that starts and ends within one call and fits in |args->enc_dst| is written
+// there directly. Only a block that's still open at the end of a call, or that doesn't
+// fit, goes through the work buffer.
+//
 // Returns COBS_RET_SUCCESS on success.
 // If any pointers are null, returns COBS_RET_ERR_BAD_ARG.
 cobs_ret_t cobs_encode_inc(cobs_enc_ctx_t* ctx,
@@ -200,8 +397,14 @@ typedef struct cobs_decode_inc_args {
   void* dec_dst;        // pointer to decoded output buffer.
   size_t enc_src_max;   // length of the |src| input buffer.
   size_t dec_dst_max;   // length of the |dst| output buffer.
+  cobs_crc_t* crc;      // if not null, the decoded bytes written are folded into it
 } cobs_decode_inc_args_t;
 
+// cobs_decode_inc_begin
+//
+// Begin an incremental decoding. To also compute a CRC of the decoded bytes as they're
+// written, start one with cobs_crc_begin and pass it as |args->crc| to every
+// cobs_decode_inc call.
 cobs_ret_t cobs_decode_inc_begin(cobs_decode_inc_ctx_t* ctx);
 cobs_ret_t cobs_decode_inc(cobs_decode_inc_ctx_t* ctx,
                            cobs_decode_inc_args_t const* args,
@@ -209,6 +412,110 @@ cobs_ret_t cobs_decode_inc(cobs_decode_inc_ctx_t* ctx,
                            size_t* out_dec_dst_len,  // how many bytes written to dst
                            bool* out_decode_complete);
 
+// Ring decoding API
+
+// A circular buffer of |cap| bytes at |buf|, holding the bytes from index |head| up to,
+// but not including, index |tail|, wrapping from the end of |buf| back to its start. Both
+// indices are always less than |cap|, and |head| == |tail| means the ring is empty, so a
+// ring holds at most |cap| - 1 bytes. This is how most DMA receive rings are described.
+typedef struct cobs_ring {
+  void* buf;
+  size_t cap;
+  size_t head;  // where the reader takes the next byte from
+  size_t tail;  // where the writer puts the next byte
+} cobs_ring_t;
+
+typedef struct cobs_decode_ring_args {
+  cobs_ring_t* enc_src;   // encoded input, read from |head| onward
+  cobs_ring_t* dec_ring;  // decoded output, appended at |tail|; null to use |dec_dst|
+  void* dec_dst;          // decoded output buffer, when |dec_ring| is null
+  size_t dec_dst_max;     // length of the |dec_dst| output buffer
+  cobs_crc_t* crc;        // if not null, the decoded bytes written are folded into it
+} cobs_decode_ring_args_t;
+
+// cobs_decode_inc_ring
+//
+// Like cobs_decode_inc, but reads the encoded bytes from a ring and optionally writes the
+// decoded bytes to one, wrapping around both as needed in one call. |args->enc_src->head|
+// is advanced past every byte read, the delimiter included, so the next frame can be
+// decoded straight after. |args->dec_ring->tail| is advanced past every byte written.
+// The number of decoded bytes written is stored in |out_dec_dst_len|, and
+// |out_decode_complete| is set once the frame's delimiter has been read.
+//
+// Returns COBS_RET_SUCCESS on success. If any of the pointers are null or a ring's
+// indices aren't less than its capacity, returns COBS_RET_ERR_BAD_ARG. If the encoded
+// bytes aren't a valid frame, returns COBS_RET_ERR_BAD_PAYLOAD and the rings' indices
+// are unspecified.
+cobs_ret_t cobs_decode_inc_ring(cobs_decode_inc_ctx_t* ctx,
+                                cobs_decode_ring_args_t const* args,
+                                size_t* out_dec_dst_len,
+                                bool* out_decode_complete);
+
+// Batch decoding API
+
+typedef struct cobs_frame {
+  size_t dec_ofs;     // offset of the decoded bytes in the output buffer
+  size_t dec_len;     // decoded length, 0 unless |status| is COBS_RET_SUCCESS
+  cobs_ret_t status;  // COBS_RET_SUCCESS or COBS_RET_ERR_BAD_PAYLOAD
+} cobs_frame_t;
+
+// cobs_decode_frames
+//
+// Decode every complete COBS_FRAME_DELIMITER-terminated frame in |enc| back to back into
+// |out_dec|, describing each one in |out_frames|. The number of frames described is
+// stored in |out_frame_count|, and the number of bytes at the end of |enc| that were not
+// consumed is stored in |out_enc_tail_len|. Keep those bytes and prepend them to the next
+// receive; they hold an incomplete final frame, plus any complete frames that didn't fit
+// in |out_frames| or |out_dec|. Since decoding never grows a frame, a |dec_max| of
+// |enc_len| is always enough.
+//
+// A frame that fails to decode (including an empty frame, from two delimiters in a row)
+// is still consumed and described, with status COBS_RET_ERR_BAD_PAYLOAD, and decoding
+// resumes after its delimiter. The contents of |out_dec| past the end of the last
+// successfully decoded frame are indeterminate.
+//
+// If any of the pointers are null, the function will fail with COBS_RET_ERR_BAD_ARG.
+//
+// If |enc| contains a complete frame but not even one fits in |out_frames| and |out_dec|,
+// the function will fail with COBS_RET_ERR_EXHAUSTED.
+cobs_ret_t cobs_decode_frames(void const* enc,
+                              size_t enc_len,
+                              void* out_dec,
+                              size_t dec_max,
+                              cobs_frame_t* out_frames,
+                              size_t frames_max,
+                              size_t* out_frame_count,
+                              size_t* out_enc_tail_len);
+
+// Kernel selection API
+
+typedef enum {
+  COBS_KERNEL_AUTO = 0,
+  COBS_KERNEL_SCALAR,
+  COBS_KERNEL_SWAR,
+  COBS_KERNEL_SSE2,
+  COBS_KERNEL_AVX2
+} cobs_kernel_t;
+
+// cobs_set_kernel
+//
+// Select the zero-scan and block-copy kernel used by the encoding and decoding functions.
+// COBS_SPEED builds on x86 compile every kernel and, unless told otherwise, pick the
+// fastest one the running CPU supports on first use. Other builds have exactly one
+// kernel, chosen at compile time. COBS_KERNEL_AUTO restores the default choice.
+//
+// This is meant for startup code and tests; don't call it while other threads are
+// encoding or decoding.
+//
+// If |kernel| isn't compiled in or isn't supported by the CPU, returns
+// COBS_RET_ERR_BAD_ARG and leaves the current kernel unchanged.
+cobs_ret_t cobs_set_kernel(cobs_kernel_t kernel);
+
+// cobs_get_kernel
+//
+// Returns the kernel currently in use. Never returns COBS_KERNEL_AUTO.
+cobs_kernel_t cobs_get_kernel(void);
+
 #ifdef __cplusplus
 }
 #endif
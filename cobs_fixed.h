@@ -0,0 +1,252 @@
+// SPDX-License-Identifier: Unlicense OR 0BSD
+
+// nanocobs fixed-length layer. Optional, header-only, C++20; for payloads whose length is
+// known at compile time. Everything here is constexpr, so it works in constant
+// expressions, and short payloads are encoded and decoded by loops with constant trip
+// counts that inline fully. At run time, longer payloads go through cobs_encode and
+// cobs_decode, whose vector kernels are faster, so link cobs.c as usual.
+#pragma once
+
+#include "cobs.h"
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+namespace cobs {
+namespace detail {
+// At run time, payloads longer than this are handed to cobs_encode and cobs_decode.
+inline constexpr size_t fixed_inline_max{ 32 };
+
+template <class T>
+concept byte_array = std::same_as<typename T::value_type, std::byte>;
+
+// cobs_decoded_len for constant expressions: the decoded length of the frame at the
+// start of |enc|, or size_t(-1) if it isn't a valid frame.
+constexpr size_t decoded_len(std::span<std::byte const> enc) noexcept {
+  if (enc.size() < 2) {
+    return size_t(-1);
+  }
+  size_t src_idx{ 0 }, dec_len{ 0 };
+  for (;;) {
+    size_t const code{ std::to_integer<size_t>(enc[src_idx]) };
+    if (!code || (code - 1 >= enc.size() - src_idx - 1)) {
+      return size_t(-1);
+    }
+    for (size_t i{ 1 }; i < code; ++i) {
+      if (enc[src_idx + i] == std::byte{ 0 }) {
+        return size_t(-1);
+      }
+    }
+    src_idx += code;
+    dec_len += code - 1;
+    if (enc[src_idx] == std::byte{ COBS_FRAME_DELIMITER }) {
+      return dec_len;
+    }
+    dec_len += (code != 0xFF);
+  }
+}
+}  // namespace detail
+
+// encoded_frame
+//
+// The encoding of an |N|-byte payload. |buf| is sized for the worst case; the frame is
+// the first |len| bytes of it, delimiter included. Payloads shorter than 255 bytes always
+// encode to exactly COBS_ENCODE_MAX(|N|) bytes, so |len| == |buf|.size() for them.
+template <size_t N>
+struct encoded_frame {
+  std::array<std::byte, COBS_ENCODE_MAX(N)> buf{};
+  size_t len{ 0 };
+
+  constexpr std::byte const* data() const noexcept { return buf.data(); }
+  constexpr size_t size() const noexcept { return len; }
+  constexpr std::span<std::byte const> bytes() const noexcept {
+    return { buf.data(), len };
+  }
+};
+
+// encode
+//
+// Encodes the |N| bytes of |dec|, producing the same bytes as cobs_encode. Cannot fail:
+// the output is sized by the type, so there are no pointers or lengths to check.
+//
+// A trivially copyable message can be passed as std::as_bytes(std::span{ &msg, 1 }).
+template <size_t N>
+constexpr encoded_frame<N> encode(std::span<std::byte const, N> dec) noexcept {
+  encoded_frame<N> out;
+  if constexpr (N > detail::fixed_inline_max) {
+    if (!std::is_constant_evaluated()) {
+      (void)cobs_encode(dec.data(), N, out.buf.data(), out.buf.size(), &out.len);
+      return out;
+    }
+  }
+
+  if constexpr (N < 255) {
+    // No full 0xFF block fits, so every byte moves one place right and each zero becomes
+    // the code byte of the block after it: the distance to the next zero or the end.
+    for (size_t i{ 0 }; i < N; ++i) {
+      out.buf[i + 1] = dec[i];
+    }
+    size_t code_idx{ 0 };
+    for (size_t i{ 1 }; i <= N; ++i) {
+      if (out.buf[i] == std::byte{ 0 }) {
+        out.buf[code_idx] = std::byte(i - code_idx);
+        code_idx = i;
+      }
+    }
+    out.buf[code_idx] = std::byte(N + 1 - code_idx);
+    out.buf[N + 1] = std::byte{ COBS_FRAME_DELIMITER };
+    out.len = N + 2;
+  } else {
+    size_t code_idx{ 0 }, dst_idx{ 1 };
+    unsigned code{ 1 };
+    for (size_t i{ 0 }; i < N; ++i) {
+      std::byte const b{ dec[i] };
+      if (b != std::byte{ 0 }) {
+        out.buf[dst_idx++] = b;
+        if (++code < 0xFF) {
+          continue;
+        }
+        if (i + 1 == N) {  // a final full 0xFF block has no trailing code byte
+          break;
+        }
+      }
+      out.buf[code_idx] = std::byte(code);
+      code_idx = dst_idx++;
+      code = 1;
+    }
+    out.buf[code_idx] = std::byte(code);
+    out.buf[dst_idx++] = std::byte{ COBS_FRAME_DELIMITER };
+    out.len = dst_idx;
+  }
+  return out;
+}
+
+// decode
+//
+// Decodes the frame at the start of |enc| into |out|, which it must fill exactly. Bytes
+// after the frame's delimiter are ignored. Returns COBS_RET_SUCCESS if and only if
+// cobs_validate accepts |enc| with a decoded length of |N|.
+//
+// Otherwise, returns what cobs_decode would with |N| bytes of output: COBS_RET_ERR_BAD_ARG
+// if |enc| is shorter than 2 bytes, COBS_RET_ERR_BAD_PAYLOAD if a zero turns up inside a
+// block, COBS_RET_ERR_EXHAUSTED if |enc| or |out| runs out before the delimiter, and
+// COBS_RET_ERR_BAD_PAYLOAD if the frame decodes to fewer than |N| bytes. The result
+// doesn't depend on which path runs. On failure, the contents of |out| are unspecified.
+template <size_t N>
+constexpr cobs_ret_t decode(std::span<std::byte const> enc,
+                            std::span<std::byte, N> out) noexcept {
+  if constexpr (N > detail::fixed_inline_max) {
+    if (!std::is_constant_evaluated()) {
+      size_t dec_len;
+      cobs_ret_t const r{ cobs_decode(enc.data(), enc.size(), out.data(), N, &dec_len) };
+      return ((r == COBS_RET_SUCCESS) && (dec_len != N)) ? COBS_RET_ERR_BAD_PAYLOAD : r;
+    }
+  }
+
+  if (enc.size() < 2) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+
+  size_t src_idx{ 0 }, dst_idx{ 0 };
+  for (;;) {
+    size_t const code{ std::to_integer<size_t>(enc[src_idx++]) };
+    if (!code) {
+      return COBS_RET_ERR_BAD_PAYLOAD;
+    }
+
+    // Like cobs_decode, walk the block as far as both |enc| and |out| allow, so a zero in
+    // that stretch is reported ahead of either running out. Copy and check without
+    // branching, so the loop vectorizes.
+    size_t const run{ std::min({ code - 1, enc.size() - src_idx, N - dst_idx }) };
+    bool zero{ false };
+    for (size_t i{ 0 }; i < run; ++i) {
+      std::byte const b{ enc[src_idx + i] };
+      zero |= (b == std::byte{ 0 });
+      out[dst_idx + i] = b;
+    }
+    if (zero) {
+      return COBS_RET_ERR_BAD_PAYLOAD;
+    }
+    src_idx += run;
+    dst_idx += run;
+    if ((run != code - 1) || (src_idx == enc.size())) {
+      return COBS_RET_ERR_EXHAUSTED;
+    }
+
+    if (enc[src_idx] == std::byte{ COBS_FRAME_DELIMITER }) {
+      break;
+    }
+    if (code != 0xFF) {
+      if (dst_idx == N) {
+        return COBS_RET_ERR_EXHAUSTED;
+      }
+      out[dst_idx++] = std::byte{ 0 };
+    }
+  }
+
+  return (dst_idx == N) ? COBS_RET_SUCCESS : COBS_RET_ERR_BAD_PAYLOAD;
+}
+
+// Compile-time constants
+//
+// Handshakes, keepalives and other canned frames can be encoded by the compiler, so they
+// sit in read-only data instead of being built at startup:
+//
+//   inline constexpr auto ping_frame{ cobs::frame_constant<cobs::bytes<0x01, 0x00>> };
+//   inline constexpr auto hello_frame{ cobs::frame_constant<cobs::text("HELLO")> };
+//   static_assert(cobs::payload_constant<hello_frame> == cobs::text("HELLO"));
+
+// bytes
+//
+// The std::array<std::byte> of the values |V|, for spelling out a constant payload.
+template <unsigned char... V>
+inline constexpr std::array<std::byte, sizeof...(V)> bytes{ std::byte{ V }... };
+
+// text
+//
+// The characters of the string literal |s| as a std::array<std::byte>, without its
+// terminating null.
+template <size_t N>
+consteval std::array<std::byte, N - 1> text(char const (&s)[N]) {
+  std::array<std::byte, N - 1> out{};
+  for (size_t i{ 0 }; i < N - 1; ++i) {
+    out[i] = std::byte(s[i]);
+  }
+  return out;
+}
+
+// frame_constant
+//
+// The encoding of the constant payload |P|, delimiter included, as a std::array of
+// exactly the encoded length.
+template <std::array P>
+  requires detail::byte_array<decltype(P)>
+inline constexpr auto frame_constant{ [] {
+  constexpr auto f{ encode(std::span{ P }) };
+  std::array<std::byte, f.len> out{};
+  for (size_t i{ 0 }; i < f.len; ++i) {
+    out[i] = f.buf[i];
+  }
+  return out;
+}() };
+
+// payload_constant
+//
+// The decoding of the constant frame |F|, as a std::array of exactly the decoded length.
+// Bytes after the frame's delimiter are ignored. It's a compile error if |F| isn't a
+// valid frame.
+template <std::array F>
+  requires detail::byte_array<decltype(F)>
+inline constexpr auto payload_constant{ [] {
+  constexpr size_t n{ detail::decoded_len(std::span{ F }) };
+  static_assert(n != size_t(-1), "not a valid COBS frame");
+  std::array<std::byte, n> out{};
+  (void)decode(std::span{ F }, std::span{ out });
+  return out;
+}() };
+
+}  // namespace cobs
@@ -0,0 +1,456 @@
+// SPDX-License-Identifier: Unlicense OR 0BSD
+#include "cobs_parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace cobs {
+namespace {
+// Don't bother waking threads for less than this many input bytes each.
+size_t constexpr s_min_task_len{ 16 * 1024 };
+
+// Encodes [src, src + len), which ends with a zero, as complete blocks into |dst|. Unlike
+// cobs_encode, there's no trailing block after the final zero, and no delimiter.
+void encode_blocks(cobs_byte_t const* src, size_t len, cobs_byte_t* dst) {
+  size_t src_idx{ 0 }, dst_idx{ 0 };
+  while (src_idx < len) {
+    size_t const max_run{ std::min<size_t>(len - src_idx, 254) };
+    auto const* const z{ static_cast<cobs_byte_t const*>(
+        std::memchr(src + src_idx, 0, max_run)) };
+    size_t const run{ z ? size_t(z - (src + src_idx)) : max_run };
+    dst[dst_idx] = cobs_byte_t(run + 1);
+    std::memcpy(dst + dst_idx + 1, src + src_idx, run);
+    dst_idx += run + 1;
+    src_idx += run + (run < 254);  // skip the zero that ended the block
+  }
+}
+}  // namespace
+
+thread_pool::thread_pool(unsigned threads) {
+  if (!threads) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  workers_.reserve(threads - 1);
+  for (unsigned i{ 1 }; i < threads; ++i) {
+    workers_.emplace_back([this]() { worker_proc(); });
+  }
+}
+
+thread_pool::~thread_pool() {
+  {
+    std::lock_guard<std::mutex> const lock{ mutex_ };
+    quit_ = true;
+  }
+  start_cv_.notify_all();
+  for (auto& w : workers_) {
+    w.join();
+  }
+}
+
+void thread_pool::run(unsigned tasks, std::function<void(unsigned)> const& fn) {
+  if (workers_.empty() || (tasks < 2)) {
+    for (unsigned i{ 0 }; i < tasks; ++i) {
+      fn(i);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> const lock{ mutex_ };
+    fn_ = &fn;
+    tasks_ = pending_ = tasks;
+    next_ = 0;
+    ++generation_;
+  }
+  start_cv_.notify_all();
+  drain();
+
+  std::unique_lock<std::mutex> lock{ mutex_ };
+  done_cv_.wait(lock, [this]() { return !pending_; });
+  fn_ = nullptr;
+}
+
+// Claims and runs tasks from the current loop until none are left to claim.
+void thread_pool::drain() {
+  std::unique_lock<std::mutex> lock{ mutex_ };
+  while (next_ < tasks_) {
+    unsigned const i{ next_++ };
+    auto const& fn{ *fn_ };
+    lock.unlock();
+    fn(i);
+    lock.lock();
+    if (!--pending_) {
+      done_cv_.notify_all();
+    }
+  }
+}
+
+void thread_pool::worker_proc() {
+  unsigned seen{ 0 };
+  std::unique_lock<std::mutex> lock{ mutex_ };
+  for (;;) {
+    start_cv_.wait(lock, [&]() { return quit_ || (generation_ != seen); });
+    if (quit_) {
+      return;
+    }
+    seen = generation_;
+    lock.unlock();
+    drain();
+    lock.lock();
+  }
+}
+
+cobs_ret_t decode_frames(thread_pool& pool,
+                         void const* enc,
+                         size_t enc_len,
+                         void* out_dec,
+                         size_t dec_max,
+                         cobs_frame_t* out_frames,
+                         size_t frames_max,
+                         size_t* out_frame_count,
+                         size_t* out_enc_tail_len) {
+  if (!enc || !out_dec || !out_frames || !out_frame_count || !out_enc_tail_len) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+
+  auto const* const src_b{ static_cast<cobs_byte_t const*>(enc) };
+  auto* const dst_b{ static_cast<cobs_byte_t*>(out_dec) };
+
+  // Find the frames serially. Until the decode pass below, each descriptor's |dec_len|
+  // holds the frame's encoded length, delimiter included.
+  size_t src_idx{ 0 }, n{ 0 };
+  bool stalled{ false };  // a complete frame remains but there's no room for it
+  while (src_idx < enc_len) {
+    auto const* const delim{ static_cast<cobs_byte_t const*>(
+        std::memchr(src_b + src_idx, COBS_FRAME_DELIMITER, enc_len - src_idx)) };
+    if (!delim) {
+      break;
+    }
+    size_t const frame_len{ size_t(delim - src_b) - src_idx };
+    if (n == frames_max) {
+      stalled = true;
+      break;
+    }
+
+    // As in cobs_decode_frames, only a well-formed frame that doesn't fit waits in the
+    // tail. A bad one is described and skipped wherever it lands.
+    cobs_ret_t status{ COBS_RET_SUCCESS };
+    if (frame_len && ((src_idx > dec_max) || (frame_len - 1 > dec_max - src_idx))) {
+      size_t dec_len, err_ofs;
+      if (cobs_validate(src_b + src_idx, frame_len + 1, &dec_len, &err_ofs) !=
+          COBS_RET_SUCCESS) {
+        status = COBS_RET_ERR_BAD_PAYLOAD;
+      } else if ((src_idx > dec_max) || (dec_len > dec_max - src_idx)) {
+        stalled = true;
+        break;
+      }
+    }
+    out_frames[n++] = cobs_frame_t{ src_idx, frame_len + 1, status };
+    src_idx += frame_len + 1;
+  }
+
+  // Split the frames into contiguous ranges balanced by encoded bytes, one per thread.
+  size_t const tasks{
+    std::min({ size_t{ pool.size() }, n, std::max<size_t>(1, src_idx / s_min_task_len) })
+  };
+  pool.run(unsigned(tasks), [&](unsigned t) {
+    auto const by_ofs{ [](cobs_frame_t const& f, size_t ofs) { return f.dec_ofs < ofs; } };
+    cobs_frame_t* const first{
+      std::lower_bound(out_frames, out_frames + n, src_idx * t / tasks, by_ofs)
+    };
+    cobs_frame_t* const last{
+      std::lower_bound(out_frames, out_frames + n, src_idx * (t + 1) / tasks, by_ofs)
+    };
+
+    for (cobs_frame_t* f{ first }; f != last; ++f) {
+      size_t const f_enc_len{ f->dec_len };
+      f->dec_len = 0;
+      if (f->status != COBS_RET_SUCCESS) {
+        continue;
+      }
+      // Decoding never grows a frame, so the bytes under its encoding are enough room,
+      // unless they run past |dec_max|, in which case the frame was checked to fit.
+      size_t const room{ std::min(f_enc_len - 1, dec_max - f->dec_ofs) };
+      f->status = (f_enc_len >= 2) && (cobs_decode(src_b + f->dec_ofs,
+                                                   f_enc_len,
+                                                   dst_b + f->dec_ofs,
+                                                   room,
+                                                   &f->dec_len) == COBS_RET_SUCCESS)
+                      ? COBS_RET_SUCCESS
+                      : COBS_RET_ERR_BAD_PAYLOAD;
+      if (f->status != COBS_RET_SUCCESS) {
+        f->dec_len = 0;
+      }
+    }
+  });
+
+  *out_frame_count = n;
+  *out_enc_tail_len = enc_len - src_idx;
+  return (stalled && !n) ? COBS_RET_ERR_EXHAUSTED : COBS_RET_SUCCESS;
+}
+
+cobs_ret_t encode(thread_pool& pool,
+                  void const* dec,
+                  size_t dec_len,
+                  void* out_enc,
+                  size_t enc_max,
+                  size_t* out_enc_len) {
+  if (!dec || !out_enc || !out_enc_len) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+  if (enc_max < 2) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+
+  size_t const max_tasks{ std::min<size_t>(pool.size(), dec_len / s_min_task_len) };
+  if (max_tasks < 2) {
+    return cobs_encode(dec, dec_len, out_enc, enc_max, out_enc_len);
+  }
+
+  auto const* const src{ static_cast<cobs_byte_t const*>(dec) };
+  auto* const dst{ static_cast<cobs_byte_t*>(out_enc) };
+
+  // Every zero starts a fresh block, so split the payload just past the first zero after
+  // each evenly spaced point. A point with no zero before the next one adds no split.
+  std::vector<size_t> splits{ 0 };
+  for (size_t t{ 1 }; t < max_tasks; ++t) {
+    size_t const from{ dec_len * t / max_tasks };
+    size_t const to{ dec_len * (t + 1) / max_tasks };
+    if (auto const* const z{ static_cast<cobs_byte_t const*>(
+            std::memchr(src + from, 0, to - from)) }) {
+      splits.push_back(size_t(z - src) + 1);
+    }
+  }
+  splits.push_back(dec_len);
+  size_t const tasks{ splits.size() - 1 };
+
+  // Size every chunk's encoding so each one can be written straight to its final place.
+  std::vector<size_t> ofs(tasks + 1);
+  pool.run(unsigned(tasks), [&](unsigned t) {
+    size_t len;
+    cobs_encoded_len(src + splits[t], splits[t + 1] - splits[t], &len);
+    // Only the final chunk gets the delimiter. The others end with a zero, after which
+    // cobs_encode would open one more, empty, block that encode_blocks leaves out.
+    ofs[t + 1] = len - ((t + 1 < tasks) ? 2 : 1);
+  });
+  for (size_t t{ 0 }; t < tasks; ++t) {
+    ofs[t + 1] += ofs[t];
+  }
+  if (ofs[tasks] >= enc_max) {  // leave room for the delimiter
+    return COBS_RET_ERR_EXHAUSTED;
+  }
+
+  pool.run(unsigned(tasks), [&](unsigned t) {
+    if (t + 1 < tasks) {
+      encode_blocks(src + splits[t], splits[t + 1] - splits[t], dst + ofs[t]);
+    } else {  // the final chunk gets cobs_encode's ending and the delimiter
+      size_t len;
+      cobs_encode(src + splits[t],
+                  dec_len - splits[t],
+                  dst + ofs[t],
+                  enc_max - ofs[t],
+                  &len);
+    }
+  });
+
+  *out_enc_len = ofs[tasks] + 1;
+  return COBS_RET_SUCCESS;
+}
+
+cobs_ret_t decode(thread_pool& pool,
+                  void const* enc,
+                  size_t enc_len,
+                  void* out_dec,
+                  size_t dec_max,
+                  size_t* out_dec_len) {
+  if (!enc || !out_dec || !out_dec_len) {
+    return COBS_RET_ERR_BAD_ARG;
+  }
+
+  size_t const max_tasks{ std::min<size_t>(pool.size(), enc_len / s_min_task_len) };
+  if (max_tasks < 2) {
+    return cobs_decode(enc, enc_len, out_dec, dec_max, out_dec_len);
+  }
+
+  auto const* const src{ static_cast<cobs_byte_t const*>(enc) };
+  auto* const dst{ static_cast<cobs_byte_t*>(out_dec) };
+
+  // Walk the code chain, which only reads one byte per block, to find the delimiter and
+  // the decoded length. Along the way, mark a block boundary about every |span| bytes so
+  // each thread can start decoding there. Anything unusual, from a missing delimiter to
+  // a frame that won't fit, is left to cobs_decode so the results match it exactly.
+  struct mark {
+    size_t src_idx, dst_idx;
+  };
+  std::vector<mark> marks{ { 0, 0 } };
+  size_t const span{ enc_len / max_tasks };
+  size_t src_idx{ 0 }, dst_idx{ 0 };
+  for (;;) {
+    cobs_byte_t const code{ src[src_idx] };
+    if (!code || (code >= enc_len - src_idx)) {
+      return cobs_decode(enc, enc_len, out_dec, dec_max, out_dec_len);
+    }
+    src_idx += code;
+    dst_idx += code - 1u;
+    if (!src[src_idx]) {
+      break;
+    }
+    dst_idx += (code != 0xFF);  // the zero that ended the block
+    if (src_idx - marks.back().src_idx >= span) {
+      marks.push_back({ src_idx, dst_idx });
+    }
+  }
+  if (dst_idx > dec_max) {
+    return cobs_decode(enc, enc_len, out_dec, dec_max, out_dec_len);
+  }
+  marks.push_back({ src_idx + 1, dst_idx });  // the last span includes the delimiter
+
+  // Decode each span from its mark. Every span but the last stops at a block boundary,
+  // where cobs_decode_inc is waiting for the next code byte to know whether the block
+  // ended with a zero. The chain walk already knows, so write that zero here.
+  std::atomic<bool> ok{ true };
+  pool.run(unsigned(marks.size() - 1), [&](unsigned t) {
+    mark const from{ marks[t] }, to{ marks[t + 1] };
+    cobs_decode_inc_ctx_t ctx;
+    cobs_decode_inc_begin(&ctx);
+    cobs_decode_inc_args_t const args{ .enc_src = src + from.src_idx,
+                                       .dec_dst = dst + from.dst_idx,
+                                       .enc_src_max = to.src_idx - from.src_idx,
+                                       .dec_dst_max = to.dst_idx - from.dst_idx,
+                                       .crc = nullptr };
+    size_t src_len, dst_len;
+    bool complete;
+    if (cobs_decode_inc(&ctx, &args, &src_len, &dst_len, &complete) != COBS_RET_SUCCESS) {
+      ok = false;  // a zero inside a block
+      return;
+    }
+    if (!complete && (ctx.code != 0xFF)) {
+      dst[from.dst_idx + dst_len++] = 0;
+    }
+    if (dst_len != to.dst_idx - from.dst_idx) {
+      ok = false;
+    }
+  });
+  if (!ok) {
+    return cobs_decode(enc, enc_len, out_dec, dec_max, out_dec_len);
+  }
+
+  *out_dec_len = dst_idx;
+  return COBS_RET_SUCCESS;
+}
+
+frame_ring::frame_ring(size_t capacity) : buf_(capacity + 1) {}
+
+size_t frame_ring::push(void const* bytes, size_t len) {
+  if (!bytes) {
+    return 0;
+  }
+
+  size_t const cap{ buf_.size() };
+  size_t tail{ tail_ };
+  size_t room{ (head_cache_ + cap - tail - 1) % cap };
+  if (room < len) {
+    head_cache_ = head_.load(std::memory_order_acquire);
+    room = (head_cache_ + cap - tail - 1) % cap;
+  }
+  len = std::min(len, room);
+
+  // Copy in at most two stretches, remembering where the last delimiter lands.
+  auto const* src{ static_cast<cobs_byte_t const*>(bytes) };
+  size_t frames_end{ cap };  // none yet
+  size_t left{ len };
+  while (left) {
+    size_t const n{ std::min(left, cap - tail) };
+    cobs_byte_t* const dst{ buf_.data() + tail };
+    memcpy(dst, src, n);
+    for (size_t i{ 0 }; i < n;) {
+      auto const* const z{ static_cast<cobs_byte_t const*>(memchr(dst + i, 0, n - i)) };
+      if (!z) {
+        break;
+      }
+      i = size_t(z - dst) + 1;
+      frames_end = (tail + i) % cap;
+    }
+    src += n;
+    left -= n;
+    tail = (tail + n) % cap;
+  }
+
+  tail_ = tail;
+  if (frames_end != cap) {
+    frames_end_.store(frames_end, std::memory_order_release);
+  }
+  return len;
+}
+
+bool frame_ring::pop(void* out_dec,
+                     size_t dec_max,
+                     size_t* out_dec_len,
+                     cobs_ret_t* out_status) {
+  if (!out_dec || !out_dec_len || !out_status) {
+    return false;
+  }
+
+  size_t const head{ head_.load(std::memory_order_relaxed) };
+  if (head == frames_end_cache_) {
+    frames_end_cache_ = frames_end_.load(std::memory_order_acquire);
+    if (head == frames_end_cache_) {
+      return false;
+    }
+  }
+
+  size_t next;
+  *out_dec_len = 0;
+  if (!buf_[head]) {  // a zero code byte is the frame's own delimiter
+    next = (head + 1) % buf_.size();
+    *out_status = COBS_RET_ERR_BAD_PAYLOAD;
+  } else {
+    cobs_ring_t enc{ .buf = buf_.data(),
+                     .cap = buf_.size(),
+                     .head = head,
+                     .tail = frames_end_cache_ };
+    cobs_decode_ring_args_t const args{ .enc_src = &enc,
+                                        .dec_ring = nullptr,
+                                        .dec_dst = out_dec,
+                                        .dec_dst_max = dec_max,
+                                        .crc = nullptr };
+    cobs_decode_inc_ctx_t ctx;
+    size_t dec_len;
+    bool complete;
+    (void)cobs_decode_inc_begin(&ctx);
+    cobs_ret_t const r{ cobs_decode_inc_ring(&ctx, &args, &dec_len, &complete) };
+
+    if (r != COBS_RET_SUCCESS) {  // |enc.head| is unspecified, so look from the start
+      next = skip_frame(head, frames_end_cache_);
+      *out_status = COBS_RET_ERR_BAD_PAYLOAD;
+    } else if (!complete) {  // the frame's delimiter is published, so |out_dec| filled up
+      next = skip_frame(enc.head, frames_end_cache_);
+      *out_status = COBS_RET_ERR_EXHAUSTED;
+    } else {
+      next = enc.head;
+      *out_dec_len = dec_len;
+      *out_status = COBS_RET_SUCCESS;
+    }
+  }
+
+  head_.store(next, std::memory_order_release);
+  return true;
+}
+
+// Returns the index just past the first delimiter in [|from|, |frames_end|), which the
+// producer guarantees is there.
+size_t frame_ring::skip_frame(size_t from, size_t frames_end) const {
+  size_t const cap{ buf_.size() };
+  for (;;) {
+    size_t const end{ (frames_end > from) ? frames_end : cap };
+    auto const* const p{ buf_.data() + from };
+    auto const* const z{ static_cast<cobs_byte_t const*>(memchr(p, 0, end - from)) };
+    if (z) {
+      return (size_t(z - buf_.data()) + 1) % cap;
+    }
+    from = 0;
+  }
+}
+
+}  // namespace cobs
@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: Unlicense OR 0BSD
+
+// nanocobs parallel layer. Optional, C++20; the C core in cobs.h/cobs.c doesn't
+// depend on it. Compile cobs_parallel.cc alongside cobs.c to use it.
+#pragma once
+
+#include "cobs.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cobs {
+
+// thread_pool
+//
+// A fixed set of worker threads that runs one parallel loop at a time. The thread calling
+// run() takes part in the loop, so a pool of size 1 has no workers and runs everything
+// inline. Constructing and destroying a pool is comparatively expensive; make one and
+// reuse it for every call.
+//
+// run() is not reentrant and must not be called from more than one thread at a time.
+class thread_pool {
+ public:
+  // A |threads| of 0 means std::thread::hardware_concurrency().
+  explicit thread_pool(unsigned threads = 0);
+  ~thread_pool();
+  thread_pool(thread_pool const&) = delete;
+  thread_pool& operator=(thread_pool const&) = delete;
+
+  // The number of threads that run() spreads work across, including the caller.
+  unsigned size() const { return unsigned(workers_.size()) + 1; }
+
+  // Calls |fn(i)| once for each i in [0, |tasks|) across the pool, returning when all
+  // of them are done. |fn| must not throw.
+  void run(unsigned tasks, std::function<void(unsigned)> const& fn);
+
+ private:
+  void worker_proc();
+  void drain();
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable start_cv_, done_cv_;
+  std::function<void(unsigned)> const* fn_{ nullptr };
+  unsigned tasks_{ 0 }, next_{ 0 }, pending_{ 0 }, generation_{ 0 };
+  bool quit_{ false };
+};
+
+// decode_frames
+//
+// The parallel counterpart of cobs_decode_frames. Every complete
+// COBS_FRAME_DELIMITER-terminated frame in |enc| is decoded with cobs_decode on |pool|,
+// and described in |out_frames| in the order it appears in |enc|. |out_frame_count| and
+// |out_enc_tail_len| mean the same as they do for cobs_decode_frames, and bad frames are
+// reported and skipped the same way.
+//
+// Unlike cobs_decode_frames, the decoded frames are not packed back to back. Each frame
+// decodes into its own region of |out_dec|, at the same offset its encoding has in |enc|,
+// so there are gaps of at least one byte between frames. A |dec_max| of |enc_len| is
+// always enough. A smaller one leaves a frame in the tail only if it's well-formed and
+// its decoded bytes would run past |dec_max| at that offset.
+//
+// If any of the pointers are null, the function will fail with COBS_RET_ERR_BAD_ARG.
+//
+// If |enc| contains a complete frame but not even one fits in |out_frames| and |out_dec|,
+// the function will fail with COBS_RET_ERR_EXHAUSTED.
+cobs_ret_t decode_frames(thread_pool& pool,
+                         void const* enc,
+                         size_t enc_len,
+                         void* out_dec,
+                         size_t dec_max,
+                         cobs_frame_t* out_frames,
+                         size_t frames_max,
+                         size_t* out_frame_count,
+                         size_t* out_enc_tail_len);
+
+// encode
+//
+// The parallel counterpart of cobs_encode, producing byte-identical output with the same
+// arguments and return values. Payloads of at least 32KiB are split just after zero bytes
+// into roughly equal chunks, one per thread in |pool|. Every chunk's exact encoded length
+// is computed first, so each thread then encodes its chunk directly into its final place
+// in |out_enc|.
+//
+// Long stretches without zeros can't be split, so they're encoded by a single thread.
+cobs_ret_t encode(thread_pool& pool,
+                  void const* dec,
+                  size_t dec_len,
+                  void* out_enc,
+                  size_t enc_max,
+                  size_t* out_enc_len);
+
+// decode
+//
+// The parallel counterpart of cobs_decode, producing identical output with the same
+// arguments and return values. Frames of at least 32KiB are decoded in two phases. First,
+// one thread walks the chain of code bytes, checking the frame's structure and decoded
+// length and splitting it into spans of whole blocks, one per thread in |pool|. Then each
+// thread decodes its span directly into its final place in |out_dec|.
+//
+// If the frame turns out to be malformed or too big for |out_dec|, it's decoded again
+// with cobs_decode, so the error and |out_dec_len| match it exactly. In that case, bytes
+// past what cobs_decode wrote may also have been overwritten.
+cobs_ret_t decode(thread_pool& pool,
+                  void const* enc,
+                  size_t enc_len,
+                  void* out_dec,
+                  size_t dec_max,
+                  size_t* out_dec_len);
+
+// frame_ring
+//
+// A lock-free single-producer, single-consumer ring that turns a raw byte stream into
+// decoded frames. One thread (typically the one reading a UART or socket) calls push()
+// with whatever bytes arrived; another calls pop() to take whole frames off the other end.
+// The producer finds the delimiters in each chunk as it copies it in, and only publishes
+// bytes up to the last one, so the consumer never waits on or scans a partial frame; it
+// decodes each frame with cobs_decode_inc_ring, reading every byte once.
+//
+// The producer and consumer indices live on separate cache lines, and each side keeps a
+// private copy of the other's index so it only touches the shared one when it looks like
+// it has run out of bytes or space.
+//
+// push() must only be called from one thread at a time, and pop() from one thread at a
+// time. The ring must be able to hold the longest encoded frame, delimiter included, or a
+// frame that doesn't fit will stall the producer.
+class frame_ring {
+ public:
+  // The ring holds up to |capacity| encoded bytes.
+  explicit frame_ring(size_t capacity);
+  frame_ring(frame_ring const&) = delete;
+  frame_ring& operator=(frame_ring const&) = delete;
+
+  size_t capacity() const { return buf_.size() - 1; }
+
+  // Producer side. Copies as many of the |len| bytes at |bytes| as fit into the ring and
+  // returns how many that was. Bytes that don't fit are the caller's to push again later.
+  size_t push(void const* bytes, size_t len);
+
+  // Consumer side. Returns false, touching nothing, if no complete frame is waiting or if
+  // any of the pointers are null. Otherwise, takes the oldest frame off the ring, decodes
+  // it into |out_dec|, and stores the result in |out_status|: COBS_RET_SUCCESS with the
+  // decoded length in |out_dec_len|, COBS_RET_ERR_BAD_PAYLOAD if the frame was malformed
+  // (including an empty frame, from two delimiters in a row), or COBS_RET_ERR_EXHAUSTED if
+  // it decoded to more than |dec_max| bytes. Failed frames are dropped, with an
+  // |out_dec_len| of 0, and the next pop() starts after their delimiter.
+  bool pop(void* out_dec, size_t dec_max, size_t* out_dec_len, cobs_ret_t* out_status);
+
+ private:
+  size_t skip_frame(size_t from, size_t frames_end) const;
+
+  std::vector<cobs_byte_t> buf_;
+
+  // Consumer's line: where the oldest frame starts, and its copy of |frames_end_|.
+  alignas(64) std::atomic<size_t> head_{ 0 };
+  size_t frames_end_cache_{ 0 };
+
+  // Producer's line: just past the newest delimiter, where the next byte goes, and its
+  // copy of |head_|.
+  alignas(64) std::atomic<size_t> frames_end_{ 0 };
+  size_t tail_{ 0 };
+  size_t head_cache_{ 0 };
+};
+
+}  // namespace cobs
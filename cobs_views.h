@@ -0,0 +1,338 @@
+// SPDX-License-Identifier: Unlicense OR 0BSD
+
+// nanocobs range layer. Optional, header-only, C++20; built on the incremental API, so
+// link cobs.c as usual.
+//
+// cobs::views::encode and cobs::views::decode lazily turn a range of bytes into its COBS
+// encoding or decoding, without materializing either side:
+//
+//   for (std::span<std::byte const> chunk : (payload | cobs::views::encode).chunks()) {
+//     socket.write(chunk.data(), chunk.size());
+//   }
+//
+// The input can be any input range of a byte-sized type (char, unsigned char, std::byte,
+// ...). Contiguous sized ranges are handed to the incremental API directly; anything else
+// is gathered into a small buffer first. The output is produced one buffer of up to
+// |view_chunk_size| bytes at a time, and can be read either byte by byte or, through
+// chunks(), as contiguous spans for bulk copies. Iterating a view consumes it: like
+// std::ranges::istream_view, begin() can only be called once, and the view must not be
+// moved once it has been.
+#pragma once
+
+#include "cobs.h"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <utility>
+
+namespace cobs {
+
+inline constexpr size_t view_chunk_size{ 512 };
+
+namespace detail {
+template <class T>
+concept byte_like = (sizeof(T) == 1) && (std::integral<T> || std::same_as<T, std::byte>);
+
+template <class R>
+concept byte_range =
+    std::ranges::input_range<R> && byte_like<std::ranges::range_value_t<R>>;
+
+// Pulls bytes from an input range in contiguous stretches: the range's own storage when
+// it's contiguous and sized, or a small staging buffer filled element by element if not.
+template <std::ranges::view V>
+class view_source {
+ public:
+  explicit view_source(V base) : base_(std::move(base)) {}
+
+  // The next stretch of unconsumed bytes, or an empty span at the end of the range.
+  std::span<cobs_byte_t const> peek() {
+    if (pos_ == len_) {
+      refill();
+    }
+    return { data_ + pos_, len_ - pos_ };
+  }
+
+  void consume(size_t n) { pos_ += n; }
+
+ private:
+  void refill() {
+    if constexpr (std::ranges::contiguous_range<V> && std::ranges::sized_range<V>) {
+      if (started_) {
+        return;  // the one stretch has been consumed
+      }
+      data_ = reinterpret_cast<cobs_byte_t const*>(std::ranges::data(base_));
+      len_ = size_t(std::ranges::size(base_));
+    } else {
+      if (!started_) {
+        it_ = std::ranges::begin(base_);
+      }
+      size_t n{ 0 };
+      for (; (n < stage_.size()) && (it_ != std::ranges::end(base_)); ++it_) {
+        stage_[n++] = static_cast<cobs_byte_t>(*it_);
+      }
+      data_ = stage_.data();
+      len_ = n;
+    }
+    started_ = true;
+    pos_ = 0;
+  }
+
+  V base_;
+  std::ranges::iterator_t<V> it_{};
+  std::array<cobs_byte_t, 256> stage_;
+  cobs_byte_t const* data_{ nullptr };
+  size_t pos_{ 0 }, len_{ 0 };
+  bool started_{ false };
+};
+
+// The buffering and iteration shared by the encode and decode views. |Derived| provides
+// produce(), which writes up to the given number of bytes and returns how many it wrote,
+// setting |done_| once there will be no more.
+template <class Derived>
+class lazy_coder {
+ public:
+  class iterator {
+   public:
+    using value_type = std::byte;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() = default;
+    explicit iterator(lazy_coder* parent) : parent_(parent) {}
+
+    std::byte operator*() const { return parent_->out_[parent_->out_pos_]; }
+    iterator& operator++() {
+      if (++parent_->out_pos_ == parent_->out_len_) {
+        parent_->fill();
+      }
+      return *this;
+    }
+    void operator++(int) { ++*this; }
+
+    friend bool operator==(iterator const& it, std::default_sentinel_t) {
+      return it.at_end();
+    }
+
+   private:
+    bool at_end() const { return parent_->out_pos_ == parent_->out_len_; }
+
+    lazy_coder* parent_{ nullptr };
+  };
+
+  class chunk_iterator {
+   public:
+    using value_type = std::span<std::byte const>;
+    using difference_type = std::ptrdiff_t;
+
+    chunk_iterator() = default;
+    explicit chunk_iterator(lazy_coder* parent) : parent_(parent) {}
+
+    std::span<std::byte const> operator*() const {
+      return { parent_->out_.data() + parent_->out_pos_,
+               parent_->out_len_ - parent_->out_pos_ };
+    }
+    chunk_iterator& operator++() {
+      parent_->out_pos_ = parent_->out_len_;
+      parent_->fill();
+      return *this;
+    }
+    void operator++(int) { ++*this; }
+
+    friend bool operator==(chunk_iterator const& it, std::default_sentinel_t) {
+      return it.at_end();
+    }
+
+   private:
+    bool at_end() const { return parent_->out_pos_ == parent_->out_len_; }
+
+    lazy_coder* parent_{ nullptr };
+  };
+
+  iterator begin() {
+    start();
+    return iterator{ this };
+  }
+  std::default_sentinel_t end() const { return {}; }
+
+  // The same output as begin()/end(), as a range of contiguous spans. Each span stays
+  // valid until the next one is read.
+  auto chunks() {
+    start();
+    return std::ranges::subrange{ chunk_iterator{ this }, std::default_sentinel };
+  }
+
+ protected:
+  bool done_{ false };
+
+ private:
+  void start() {
+    if (!started_) {
+      started_ = true;
+      static_cast<Derived*>(this)->begin_coding();
+      fill();
+    }
+  }
+
+  // Produces the next buffer of output, leaving |out_pos_| == |out_len_| only at the end.
+  void fill() {
+    out_pos_ = out_len_ = 0;
+    while (!out_len_ && !done_) {
+      out_len_ = static_cast<Derived*>(this)->produce(out_.data(), out_.size());
+    }
+  }
+
+  std::array<std::byte, view_chunk_size> out_;  // not cleared: only written bytes are read
+  size_t out_pos_{ 0 }, out_len_{ 0 };
+  bool started_{ false };
+};
+}  // namespace detail
+
+// encode_view
+//
+// The COBS encoding of the bytes of |V|, delimiter included, as produced by
+// cobs_encode_inc and cobs_encode_inc_end.
+template <std::ranges::view V>
+  requires detail::byte_range<V>
+class encode_view : public std::ranges::view_interface<encode_view<V>>,
+                    public detail::lazy_coder<encode_view<V>> {
+ public:
+  explicit encode_view(V base) : src_(std::move(base)) {}
+
+  using detail::lazy_coder<encode_view<V>>::begin;
+  using detail::lazy_coder<encode_view<V>>::end;
+
+ private:
+  friend class detail::lazy_coder<encode_view<V>>;
+
+  // Deferred to the first begin(), since |ctx_| points at |work_|.
+  void begin_coding() { (void)cobs_encode_inc_begin(&ctx_, work_.data(), work_.size()); }
+
+  size_t produce(std::byte* out, size_t out_max) {
+    size_t written{ 0 };
+    while ((written < out_max) && !this->done_) {
+      size_t dst_len;
+      if (!ending_) {
+        auto const src{ src_.peek() };
+        if (src.empty()) {
+          ending_ = true;
+          continue;
+        }
+        cobs_encode_inc_args_t const args{ .dec_src = src.data(),
+                                           .enc_dst = out + written,
+                                           .dec_src_max = src.size(),
+                                           .enc_dst_max = out_max - written,
+                                           .crc = nullptr };
+        size_t src_len;
+        (void)cobs_encode_inc(&ctx_, &args, &src_len, &dst_len);
+        src_.consume(src_len);
+      } else {
+        (void)cobs_encode_inc_end(&ctx_, out + written, out_max - written, &dst_len,
+                                  &this->done_);
+      }
+      written += dst_len;
+    }
+    return written;
+  }
+
+  detail::view_source<V> src_;
+  cobs_enc_ctx_t ctx_{};
+  std::array<cobs_byte_t, 255> work_;
+  bool ending_{ false };
+};
+
+template <class R>
+encode_view(R&&) -> encode_view<std::views::all_t<R>>;
+
+// decode_view
+//
+// The decoding of the first COBS frame in the bytes of |V|, as produced by
+// cobs_decode_inc. Iteration stops at the frame's delimiter, and anything after it is
+// left unread.
+//
+// If the frame is malformed, or |V| ends before its delimiter, iteration ends early.
+// status() tells the cases apart: it's COBS_RET_SUCCESS once the whole frame has been
+// decoded, COBS_RET_ERR_BAD_PAYLOAD if it's malformed, and COBS_RET_ERR_EXHAUSTED if
+// the delimiter hasn't been reached (yet, or ever).
+template <std::ranges::view V>
+  requires detail::byte_range<V>
+class decode_view : public std::ranges::view_interface<decode_view<V>>,
+                    public detail::lazy_coder<decode_view<V>> {
+ public:
+  explicit decode_view(V base) : src_(std::move(base)) {}
+
+  using detail::lazy_coder<decode_view<V>>::begin;
+  using detail::lazy_coder<decode_view<V>>::end;
+
+  cobs_ret_t status() const { return status_; }
+
+ private:
+  friend class detail::lazy_coder<decode_view<V>>;
+
+  void begin_coding() { (void)cobs_decode_inc_begin(&ctx_); }
+
+  size_t produce(std::byte* out, size_t out_max) {
+    size_t written{ 0 };
+    while ((written < out_max) && !this->done_) {
+      auto const src{ src_.peek() };
+      if (src.empty()) {
+        this->done_ = true;  // no delimiter
+        break;
+      }
+      cobs_decode_inc_args_t const args{ .enc_src = src.data(),
+                                         .dec_dst = out + written,
+                                         .enc_src_max = src.size(),
+                                         .dec_dst_max = out_max - written,
+                                         .crc = nullptr };
+      size_t src_len, dst_len;
+      bool complete;
+      cobs_ret_t const r{ cobs_decode_inc(&ctx_, &args, &src_len, &dst_len, &complete) };
+      if (r != COBS_RET_SUCCESS) {
+        status_ = r;
+        this->done_ = true;
+        break;
+      }
+      src_.consume(src_len);
+      written += dst_len;
+      if (complete) {
+        status_ = COBS_RET_SUCCESS;
+        this->done_ = true;
+      }
+    }
+    return written;
+  }
+
+  detail::view_source<V> src_;
+  cobs_decode_inc_ctx_t ctx_{};
+  cobs_ret_t status_{ COBS_RET_ERR_EXHAUSTED };
+};
+
+template <class R>
+decode_view(R&&) -> decode_view<std::views::all_t<R>>;
+
+namespace views {
+namespace detail {
+// A range adaptor that works both as |fn(r)| and as |r | fn|.
+template <template <class> class View>
+struct adaptor {
+  template <std::ranges::viewable_range R>
+    requires cobs::detail::byte_range<R>
+  auto operator()(R&& r) const {
+    return View<std::views::all_t<R>>{ std::views::all(std::forward<R>(r)) };
+  }
+
+  template <std::ranges::viewable_range R>
+    requires cobs::detail::byte_range<R>
+  friend auto operator|(R&& r, adaptor const& a) {
+    return a(std::forward<R>(r));
+  }
+};
+}  // namespace detail
+
+inline constexpr detail::adaptor<encode_view> encode{};
+inline constexpr detail::adaptor<decode_view> decode{};
+}  // namespace views
+
+}  // namespace cobs
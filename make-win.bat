@@ -14,15 +14,34 @@ cl.exe /W4 /WX /MP /std:c11 /c ^
     tests\cobs_encode_max_c.c ^
     || exit /b 1
 
+cl.exe /W4 /WX /MP /EHsc /std:c++20 /c ^
+    /Fobuild\ ^
+    cobs_parallel.cc ^
+    || exit /b 1
+
 cl.exe /W4 /WX /MP /EHsc /std:c++20 /c ^
     /Fobuild\tests\ ^
+    tests\test_cobs_crc.cc ^
     tests\test_cobs_decode.cc ^
+    tests\test_cobs_decode_frames.cc ^
     tests\test_cobs_decode_inc.cc ^
+    tests\test_cobs_decode_inplace.cc ^
+    tests\test_cobs_decode_ring.cc ^
+    tests\test_cobs_decode_scatter.cc ^
     tests\test_cobs_decode_tinyframe.cc ^
     tests\test_cobs_encode.cc ^
+    tests\test_cobs_encode_gather.cc ^
     tests\test_cobs_encode_inc.cc ^
+    tests\test_cobs_encode_inplace.cc ^
     tests\test_cobs_encode_max.cc ^
     tests\test_cobs_encode_tinyframe.cc ^
+    tests\test_cobs_encoded_len.cc ^
+    tests\test_cobs_fixed.cc ^
+    tests\test_cobs_frame_ring.cc ^
+    tests\test_cobs_kernels.cc ^
+    tests\test_cobs_parallel.cc ^
+    tests\test_cobs_validate.cc ^
+    tests\test_cobs_views.cc ^
     tests\test_many_random_payloads.cc ^
     tests\test_paper_figures.cc ^
     tests\test_wikipedia.cc ^
@@ -32,13 +51,28 @@ cl.exe /W4 /WX /MP /EHsc /std:c++20 /c ^
 link.exe /nologo /out:build\cobs_unittests.exe ^
     build\cobs.obj ^
     build\cobs_encode_max_c.obj ^
+    build\cobs_parallel.obj ^
+    build\tests\test_cobs_crc.obj ^
     build\tests\test_cobs_decode.obj ^
+    build\tests\test_cobs_decode_frames.obj ^
     build\tests\test_cobs_decode_inc.obj ^
+    build\tests\test_cobs_decode_inplace.obj ^
+    build\tests\test_cobs_decode_ring.obj ^
+    build\tests\test_cobs_decode_scatter.obj ^
     build\tests\test_cobs_decode_tinyframe.obj ^
     build\tests\test_cobs_encode.obj ^
+    build\tests\test_cobs_encode_gather.obj ^
     build\tests\test_cobs_encode_inc.obj ^
+    build\tests\test_cobs_encode_inplace.obj ^
     build\tests\test_cobs_encode_max.obj ^
     build\tests\test_cobs_encode_tinyframe.obj ^
+    build\tests\test_cobs_encoded_len.obj ^
+    build\tests\test_cobs_fixed.obj ^
+    build\tests\test_cobs_frame_ring.obj ^
+    build\tests\test_cobs_kernels.obj ^
+    build\tests\test_cobs_parallel.obj ^
+    build\tests\test_cobs_validate.obj ^
+    build\tests\test_cobs_views.obj ^
     build\tests\test_many_random_payloads.obj ^
     build\tests\test_paper_figures.obj ^
     build\tests\test_wikipedia.obj ^
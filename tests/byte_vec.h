@@ -1,8 +1,20 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <random>
 #include <vector>
 
 using byte_t = unsigned char;
 using byte_vec_t = std::vector<byte_t>;
 
+// |len| random bytes with zeros mixed in at a random density, from all zeros to about one
+// in 400, so runs of every length from empty to longer than a full block turn up.
+inline byte_vec_t random_payload(std::mt19937& mt, size_t len) {
+  byte_vec_t v(len);
+  auto const zero_every{ 1 + (mt() % 400) };
+  std::generate(v.begin(), v.end(), [&]() {
+    return byte_t((mt() % zero_every) ? 1 + (mt() % 255) : 0);
+  });
+  return v;
+}
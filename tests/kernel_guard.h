@@ -0,0 +1,16 @@
+#pragma once
+
+#include "../cobs.h"
+
+// Every kernel, for tests that run the same checks under each one in turn.
+inline constexpr cobs_kernel_t s_kernels[]{
+  COBS_KERNEL_SCALAR, COBS_KERNEL_SWAR, COBS_KERNEL_SSE2, COBS_KERNEL_AVX2
+};
+
+// Restores automatic kernel selection when a test case ends.
+struct kernel_guard {
+  kernel_guard() = default;
+  kernel_guard(kernel_guard const&) = delete;
+  kernel_guard& operator=(kernel_guard const&) = delete;
+  ~kernel_guard() { cobs_set_kernel(COBS_KERNEL_AUTO); }
+};
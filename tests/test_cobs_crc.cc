@@ -0,0 +1,218 @@
+#include "../cobs.h"
+#include "byte_vec.h"
+#include "doctest_wrapper.h"
+#include "kernel_guard.h"
+
+#include <algorithm>
+#include <random>
+
+namespace {
+cobs_crc_kind_t const s_crc_kinds[]{ COBS_CRC16_CCITT, COBS_CRC32, COBS_CRC32C };
+
+// Bit at a time, straight from the definitions, to check the tables and the instruction.
+uint32_t reference_crc(cobs_crc_kind_t kind, byte_vec_t const& v) {
+  if (kind == COBS_CRC16_CCITT) {
+    uint32_t c{ 0xFFFF };
+    for (byte_t const b : v) {
+      c ^= uint32_t(b) << 8;
+      for (int i{ 0 }; i < 8; ++i) {
+        c = ((c << 1) ^ ((c & 0x8000) ? 0x1021 : 0)) & 0xFFFF;
+      }
+    }
+    return c;
+  }
+  uint32_t const poly{ (kind == COBS_CRC32) ? 0xEDB88320u : 0x82F63B78u };
+  uint32_t c{ 0xFFFFFFFF };
+  for (byte_t const b : v) {
+    c ^= b;
+    for (int i{ 0 }; i < 8; ++i) {
+      c = (c >> 1) ^ ((c & 1) ? poly : 0);
+    }
+  }
+  return ~c;
+}
+
+cobs_crc_t begin(cobs_crc_kind_t kind) {
+  cobs_crc_t crc;
+  REQUIRE(cobs_crc_begin(&crc, kind) == COBS_RET_SUCCESS);
+  return crc;
+}
+}  // namespace
+
+TEST_CASE("cobs_crc validation") {
+  cobs_crc_t crc;
+  byte_t const b{ 0 };
+  REQUIRE(cobs_crc_begin(nullptr, COBS_CRC32) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_crc_begin(&crc, COBS_CRC32) == COBS_RET_SUCCESS);
+  REQUIRE(cobs_crc_update(nullptr, &b, 1) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_crc_update(&crc, nullptr, 1) == COBS_RET_ERR_BAD_ARG);
+
+  byte_t enc[8];
+  size_t len;
+  REQUIRE(cobs_encode_crc(&b, 1, enc, sizeof(enc), &len, nullptr) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_decode_crc(enc, 3, enc, sizeof(enc), &len, nullptr) ==
+          COBS_RET_ERR_BAD_ARG);
+}
+
+TEST_CASE("cobs_crc check values") {
+  kernel_guard g;
+  byte_vec_t const check{ '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+  for (cobs_kernel_t const k : s_kernels) {
+    if (cobs_set_kernel(k) != COBS_RET_SUCCESS) {
+      continue;
+    }
+    CAPTURE(k);
+    for (cobs_crc_kind_t const kind : s_crc_kinds) {
+      cobs_crc_t crc{ begin(kind) };
+      REQUIRE(cobs_crc_update(&crc, check.data(), check.size()) == COBS_RET_SUCCESS);
+      uint32_t const expected{ (kind == COBS_CRC16_CCITT) ? 0x29B1u
+                               : (kind == COBS_CRC32)     ? 0xCBF43926u
+                                                          : 0xE3069283u };
+      REQUIRE(cobs_crc_value(&crc) == expected);
+    }
+  }
+
+  cobs_crc_t none{ begin(COBS_CRC_NONE) };
+  REQUIRE(cobs_crc_update(&none, check.data(), check.size()) == COBS_RET_SUCCESS);
+  REQUIRE(cobs_crc_value(&none) == 0);
+}
+
+TEST_CASE("cobs_encode_crc and cobs_decode_crc") {
+  kernel_guard g;
+  std::mt19937 mt{ 31415u };
+  for (cobs_kernel_t const k : s_kernels) {
+    if (cobs_set_kernel(k) != COBS_RET_SUCCESS) {
+      continue;
+    }
+    CAPTURE(k);
+    for (auto iter{ 0u }; iter < 100; ++iter) {
+      byte_vec_t const dec{ random_payload(mt, 1 + (mt() % 3000)) };
+      for (cobs_crc_kind_t const kind : s_crc_kinds) {
+        CAPTURE(kind);
+        uint32_t const expected{ reference_crc(kind, dec) };
+
+        byte_vec_t enc(COBS_ENCODE_MAX(dec.size()));
+        size_t enc_len{ 0u };
+        cobs_crc_t enc_crc{ begin(kind) };
+        REQUIRE(cobs_encode_crc(
+                    dec.data(), dec.size(), enc.data(), enc.size(), &enc_len, &enc_crc) ==
+                COBS_RET_SUCCESS);
+        enc.resize(enc_len);
+        REQUIRE(cobs_crc_value(&enc_crc) == expected);
+
+        // The output is exactly cobs_encode's.
+        byte_vec_t plain(COBS_ENCODE_MAX(dec.size()));
+        size_t plain_len{ 0u };
+        REQUIRE(cobs_encode(
+                    dec.data(), dec.size(), plain.data(), plain.size(), &plain_len) ==
+                COBS_RET_SUCCESS);
+        plain.resize(plain_len);
+        REQUIRE(enc == plain);
+
+        byte_vec_t out(enc.size());
+        size_t out_len{ 0u };
+        cobs_crc_t dec_crc{ begin(kind) };
+        REQUIRE(cobs_decode_crc(
+                    enc.data(), enc.size(), out.data(), out.size(), &out_len, &dec_crc) ==
+                COBS_RET_SUCCESS);
+        out.resize(out_len);
+        REQUIRE(out == dec);
+        REQUIRE(cobs_crc_value(&dec_crc) == expected);
+      }
+    }
+  }
+}
+
+TEST_CASE("cobs_crc continues across calls") {
+  byte_vec_t const header{ 0x01, 0x00, 0x02 }, body{ 0x00, 0x11, 0x22, 0x00 };
+  byte_vec_t whole{ header };
+  whole.insert(whole.end(), body.begin(), body.end());
+
+  cobs_crc_t crc{ begin(COBS_CRC32C) };
+  REQUIRE(cobs_crc_update(&crc, header.data(), header.size()) == COBS_RET_SUCCESS);
+  byte_vec_t enc(COBS_ENCODE_MAX(body.size()));
+  size_t enc_len{ 0u };
+  REQUIRE(
+      cobs_encode_crc(body.data(), body.size(), enc.data(), enc.size(), &enc_len, &crc) ==
+      COBS_RET_SUCCESS);
+  REQUIRE(cobs_crc_value(&crc) == reference_crc(COBS_CRC32C, whole));
+}
+
+TEST_CASE("cobs_crc is untouched on failure") {
+  byte_vec_t const dec(300, 0x42);
+  byte_vec_t enc(100);
+  size_t len{ 0u };
+  cobs_crc_t crc{ begin(COBS_CRC32) };
+  cobs_crc_t const before{ crc };
+  REQUIRE(cobs_encode_crc(dec.data(), dec.size(), enc.data(), enc.size(), &len, &crc) ==
+          COBS_RET_ERR_EXHAUSTED);
+  REQUIRE(crc.state == before.state);
+
+  byte_vec_t const bad{ 0x03, 0x11, 0x00, 0x00 };
+  byte_vec_t out(8);
+  REQUIRE(cobs_decode_crc(bad.data(), bad.size(), out.data(), out.size(), &len, &crc) ==
+          COBS_RET_ERR_BAD_PAYLOAD);
+  REQUIRE(crc.state == before.state);
+}
+
+TEST_CASE("Incremental encoding and decoding carry a CRC") {
+  std::mt19937 mt{ 27182u };
+  for (auto iter{ 0u }; iter < 200; ++iter) {
+    byte_vec_t const dec{ random_payload(mt, mt() % 2000) };
+    cobs_crc_kind_t const kind{ s_crc_kinds[mt() % 3] };
+    CAPTURE(kind);
+    uint32_t const expected{ reference_crc(kind, dec) };
+
+    byte_t work[255];
+    cobs_enc_ctx_t ectx;
+    REQUIRE(cobs_encode_inc_begin(&ectx, work, sizeof(work)) == COBS_RET_SUCCESS);
+    cobs_crc_t ecrc;
+    REQUIRE(cobs_crc_begin(&ecrc, kind) == COBS_RET_SUCCESS);
+    byte_vec_t enc(COBS_ENCODE_MAX(dec.size()));
+    size_t src_pos{ 0u }, enc_pos{ 0u };
+    while (src_pos < dec.size()) {
+      size_t const chunk{ std::min(size_t(1 + (mt() % 97)), dec.size() - src_pos) };
+      cobs_encode_inc_args_t const args{ .dec_src = dec.data() + src_pos,
+                                         .enc_dst = enc.data() + enc_pos,
+                                         .dec_src_max = chunk,
+                                         .enc_dst_max = enc.size() - enc_pos,
+                                         .crc = &ecrc };
+      size_t src_len{ 0u }, dst_len{ 0u };
+      REQUIRE(cobs_encode_inc(&ectx, &args, &src_len, &dst_len) == COBS_RET_SUCCESS);
+      src_pos += src_len;
+      enc_pos += dst_len;
+    }
+    bool finished{ false };
+    size_t end_len{ 0u };
+    REQUIRE(cobs_encode_inc_end(
+                &ectx, enc.data() + enc_pos, enc.size() - enc_pos, &end_len, &finished) ==
+            COBS_RET_SUCCESS);
+    REQUIRE(finished);
+    enc.resize(enc_pos + end_len);
+    REQUIRE(cobs_crc_value(&ecrc) == expected);
+
+    cobs_decode_inc_ctx_t dctx;
+    REQUIRE(cobs_decode_inc_begin(&dctx) == COBS_RET_SUCCESS);
+    cobs_crc_t dcrc;
+    REQUIRE(cobs_crc_begin(&dcrc, kind) == COBS_RET_SUCCESS);
+    byte_vec_t out(enc.size());
+    size_t enc_read{ 0u }, out_pos{ 0u };
+    bool complete{ false };
+    while (!complete) {
+      size_t const chunk{ std::min(size_t(1 + (mt() % 97)), enc.size() - enc_read) };
+      cobs_decode_inc_args_t const args{ .enc_src = enc.data() + enc_read,
+                                         .dec_dst = out.data() + out_pos,
+                                         .enc_src_max = chunk,
+                                         .dec_dst_max = out.size() - out_pos,
+                                         .crc = &dcrc };
+      size_t src_len{ 0u }, dst_len{ 0u };
+      REQUIRE(cobs_decode_inc(&dctx, &args, &src_len, &dst_len, &complete) ==
+              COBS_RET_SUCCESS);
+      enc_read += src_len;
+      out_pos += dst_len;
+    }
+    out.resize(out_pos);
+    REQUIRE(out == dec);
+    REQUIRE(cobs_crc_value(&dcrc) == expected);
+  }
+}
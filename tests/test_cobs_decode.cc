@@ -348,3 +348,25 @@ TEST_CASE("Decode: in-place (output buffer == input buffer)") {
     REQUIRE(byte_vec_t(buf.data(), buf.data() + dec_len) == dec);
   }
 }
+
+TEST_CASE("Decode: embedded zero at every offset in a block") {
+  for (unsigned code : { 2u, 17u, 33u, 64u, 0xFFu }) {
+    for (unsigned zero_at{ 1 }; zero_at < code; ++zero_at) {
+      byte_vec_t enc(code + 1, 0x5A);
+      enc[0] = byte_t(code);
+      enc[zero_at] = 0x00;
+      enc[code] = 0x00;
+
+      byte_vec_t dec(code);
+      size_t dec_len{ 0u };
+      REQUIRE(cobs_decode(enc.data(), enc.size(), dec.data(), dec.size(), &dec_len) ==
+              COBS_RET_ERR_BAD_PAYLOAD);
+
+      // The output fills up before the decoder reaches the zero.
+      if (zero_at > 1) {
+        REQUIRE(cobs_decode(enc.data(), enc.size(), dec.data(), zero_at - 2, &dec_len) ==
+                COBS_RET_ERR_EXHAUSTED);
+      }
+    }
+  }
+}
@@ -0,0 +1,226 @@
+#include "../cobs.h"
+#include "byte_vec.h"
+#include "doctest_wrapper.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+byte_vec_t encode(byte_vec_t const& dec) {
+  byte_vec_t enc(COBS_ENCODE_MAX(dec.size()));
+  size_t enc_len{ 0u };
+  byte_t const empty{ 0 };  // an empty vector's data() may be null
+  REQUIRE(cobs_encode(dec.empty() ? &empty : dec.data(),
+                      dec.size(),
+                      enc.data(),
+                      enc.size(),
+                      &enc_len) ==
+          COBS_RET_SUCCESS);
+  enc.resize(enc_len);
+  return enc;
+}
+
+struct batch {
+  cobs_ret_t ret;
+  std::vector<cobs_frame_t> frames;
+  byte_vec_t dec;
+  size_t tail_len;
+};
+
+batch decode_frames(byte_vec_t const& enc, size_t dec_max, size_t frames_max) {
+  batch b{ COBS_RET_SUCCESS,
+           std::vector<cobs_frame_t>(std::max<size_t>(frames_max, 1)),
+           byte_vec_t(std::max<size_t>(dec_max, 1)),
+           0 };
+  size_t n{ 0 };
+  b.ret = cobs_decode_frames(enc.data(),
+                             enc.size(),
+                             b.dec.data(),
+                             dec_max,
+                             b.frames.data(),
+                             frames_max,
+                             &n,
+                             &b.tail_len);
+  b.frames.resize(n);
+  return b;
+}
+
+byte_vec_t frame_bytes(batch const& b, size_t i) {
+  auto const first{ b.dec.begin() + static_cast<std::ptrdiff_t>(b.frames[i].dec_ofs) };
+  return byte_vec_t(first, first + static_cast<std::ptrdiff_t>(b.frames[i].dec_len));
+}
+
+byte_vec_t concat(std::vector<byte_vec_t> const& v) {
+  byte_vec_t out;
+  for (auto const& x : v) {
+    out.insert(out.end(), x.begin(), x.end());
+  }
+  return out;
+}
+}  // namespace
+
+TEST_CASE("cobs_decode_frames bad args") {
+  byte_t enc[]{ 0x01, 0x00 }, dec[4];
+  cobs_frame_t frames[2];
+  size_t n, tail;
+
+  REQUIRE(cobs_decode_frames(nullptr, 2, dec, 4, frames, 2, &n, &tail) ==
+          COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_decode_frames(enc, 2, nullptr, 4, frames, 2, &n, &tail) ==
+          COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_decode_frames(enc, 2, dec, 4, nullptr, 2, &n, &tail) ==
+          COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_decode_frames(enc, 2, dec, 4, frames, 2, nullptr, &tail) ==
+          COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_decode_frames(enc, 2, dec, 4, frames, 2, &n, nullptr) ==
+          COBS_RET_ERR_BAD_ARG);
+}
+
+TEST_CASE("cobs_decode_frames") {
+  SUBCASE("Empty input") {
+    byte_t enc[1], dec[1];
+    cobs_frame_t frames[1];
+    size_t n{ 1 }, tail{ 1 };
+    REQUIRE(cobs_decode_frames(enc, 0, dec, 1, frames, 1, &n, &tail) == COBS_RET_SUCCESS);
+    REQUIRE(n == 0);
+    REQUIRE(tail == 0);
+  }
+
+  SUBCASE("Several frames are packed back to back") {
+    std::vector<byte_vec_t> const payloads{ { 0x11 }, {}, { 0x00, 0x22, 0x00 }, { 0x33 } };
+    std::vector<byte_vec_t> encs;
+    std::transform(payloads.begin(), payloads.end(), std::back_inserter(encs), encode);
+
+    auto const b{ decode_frames(concat(encs), 16, 8) };
+    REQUIRE(b.ret == COBS_RET_SUCCESS);
+    REQUIRE(b.tail_len == 0);
+    REQUIRE(b.frames.size() == payloads.size());
+    size_t ofs{ 0 };
+    for (size_t i{ 0 }; i < payloads.size(); ++i) {
+      REQUIRE(b.frames[i].status == COBS_RET_SUCCESS);
+      REQUIRE(b.frames[i].dec_ofs == ofs);
+      REQUIRE(frame_bytes(b, i) == payloads[i]);
+      ofs += payloads[i].size();
+    }
+  }
+
+  SUBCASE("Incomplete final frame is left in the tail") {
+    byte_vec_t enc{ concat({ encode({ 0x11, 0x22 }), encode({ 0x33, 0x44, 0x55 }) }) };
+    enc.pop_back();
+    auto const b{ decode_frames(enc, 16, 8) };
+    REQUIRE(b.ret == COBS_RET_SUCCESS);
+    REQUIRE(b.frames.size() == 1);
+    REQUIRE(frame_bytes(b, 0) == byte_vec_t{ 0x11, 0x22 });
+    REQUIRE(b.tail_len == 4);
+  }
+
+  SUBCASE("Bad frames are reported and skipped") {
+    byte_vec_t const enc{ concat({ encode({ 0x11 }),
+                                   byte_vec_t{ 0x05, 0x01, 0x00 },  // jumps over a zero
+                                   byte_vec_t{ 0x00 },              // empty frame
+                                   encode({ 0x22 }) }) };
+    auto const b{ decode_frames(enc, 16, 8) };
+    REQUIRE(b.ret == COBS_RET_SUCCESS);
+    REQUIRE(b.tail_len == 0);
+    REQUIRE(b.frames.size() == 4);
+    REQUIRE(b.frames[0].status == COBS_RET_SUCCESS);
+    REQUIRE(b.frames[1].status == COBS_RET_ERR_BAD_PAYLOAD);
+    REQUIRE(b.frames[1].dec_len == 0);
+    REQUIRE(b.frames[2].status == COBS_RET_ERR_BAD_PAYLOAD);
+    REQUIRE(b.frames[2].dec_len == 0);
+    REQUIRE(b.frames[3].status == COBS_RET_SUCCESS);
+    REQUIRE(b.frames[3].dec_ofs == 1);
+    REQUIRE(frame_bytes(b, 3) == byte_vec_t{ 0x22 });
+  }
+
+  SUBCASE("Frames that don't fit the descriptor array stay in the tail") {
+    byte_vec_t const second{ encode({ 0x22, 0x33 }) };
+    auto const b{ decode_frames(concat({ encode({ 0x11 }), second }), 16, 1) };
+    REQUIRE(b.ret == COBS_RET_SUCCESS);
+    REQUIRE(b.frames.size() == 1);
+    REQUIRE(b.tail_len == second.size());
+  }
+
+  SUBCASE("Frames that don't fit the output buffer stay in the tail") {
+    byte_vec_t const second{ encode({ 0x22, 0x33 }) };
+    auto const b{ decode_frames(concat({ encode({ 0x11 }), second }), 2, 8) };
+    REQUIRE(b.ret == COBS_RET_SUCCESS);
+    REQUIRE(b.frames.size() == 1);
+    REQUIRE(b.tail_len == second.size());
+  }
+
+  SUBCASE("Exhausted if not even the first frame fits") {
+    byte_vec_t const enc{ encode({ 0x11, 0x22, 0x33 }) };
+    REQUIRE(decode_frames(enc, 2, 8).ret == COBS_RET_ERR_EXHAUSTED);
+    REQUIRE(decode_frames(enc, 16, 0).ret == COBS_RET_ERR_EXHAUSTED);
+  }
+
+  SUBCASE("Bad frame that overflows the output buffer is still consumed") {
+    byte_vec_t const enc{ 0x05, 'a', 0x00, 0x02, 0x11, 0x00 };
+    auto const b{ decode_frames(enc, 1, 8) };
+    REQUIRE(b.ret == COBS_RET_SUCCESS);
+    REQUIRE(b.tail_len == 0);
+    REQUIRE(b.frames.size() == 2);
+    REQUIRE(b.frames[0].status == COBS_RET_ERR_BAD_PAYLOAD);
+    REQUIRE(b.frames[0].dec_len == 0);
+    REQUIRE(b.frames[1].status == COBS_RET_SUCCESS);
+    REQUIRE(frame_bytes(b, 1) == byte_vec_t{ 0x11 });
+
+    auto const none{ decode_frames(enc, 0, 8) };  // the good frame no longer fits
+    REQUIRE(none.ret == COBS_RET_SUCCESS);
+    REQUIRE(none.frames.size() == 1);
+    REQUIRE(none.tail_len == 3);
+  }
+
+  SUBCASE("Incomplete frame that overflows the output buffer isn't exhausted") {
+    byte_vec_t enc{ encode({ 0x11, 0x22, 0x33 }) };
+    enc.pop_back();
+    auto const b{ decode_frames(enc, 2, 8) };
+    REQUIRE(b.ret == COBS_RET_SUCCESS);
+    REQUIRE(b.frames.empty());
+    REQUIRE(b.tail_len == enc.size());
+  }
+
+  SUBCASE("No frames fit but none are complete") {
+    byte_vec_t enc{ encode({ 0x11, 0x22, 0x33 }) };
+    enc.pop_back();
+    auto const b{ decode_frames(enc, 0, 0) };
+    REQUIRE(b.ret == COBS_RET_SUCCESS);
+    REQUIRE(b.tail_len == enc.size());
+  }
+}
+
+TEST_CASE("cobs_decode_frames: random stream in random receive sizes") {
+  std::mt19937 mt{ 5678u };
+  std::vector<byte_vec_t> payloads(200);
+  for (auto& p : payloads) {
+    p.resize(mt() % 1200);
+    std::generate(p.begin(), p.end(), [&]() { return byte_t((mt() % 4) ? mt() : 0); });
+  }
+  std::vector<byte_vec_t> encs;
+  std::transform(payloads.begin(), payloads.end(), std::back_inserter(encs), encode);
+  byte_vec_t const stream{ concat(encs) };
+
+  std::vector<byte_vec_t> received;
+  byte_vec_t rx;  // carried-over tail followed by the newest read
+  size_t pos{ 0 };
+  while ((pos < stream.size()) || !rx.empty()) {
+    size_t const n{ std::min<size_t>(1 + (mt() % 4096), stream.size() - pos) };
+    rx.insert(rx.end(),
+              stream.begin() + static_cast<std::ptrdiff_t>(pos),
+              stream.begin() + static_cast<std::ptrdiff_t>(pos + n));
+    pos += n;
+
+    auto const b{ decode_frames(rx, rx.size(), 16) };
+    REQUIRE(b.ret == COBS_RET_SUCCESS);
+    for (size_t i{ 0 }; i < b.frames.size(); ++i) {
+      REQUIRE(b.frames[i].status == COBS_RET_SUCCESS);
+      received.push_back(frame_bytes(b, i));
+    }
+    rx.erase(rx.begin(), rx.end() - static_cast<std::ptrdiff_t>(b.tail_len));
+  }
+
+  REQUIRE(rx.empty());
+  REQUIRE(received == payloads);
+}
@@ -24,7 +24,8 @@ TEST_CASE("cobs_decode_inc bad args") {
   cobs_decode_inc_args_t args{ .enc_src = enc.data(),
                                .dec_dst = dec.data(),
                                .enc_src_max = enc.size(),
-                               .dec_dst_max = dec.size() };
+                               .dec_dst_max = dec.size(),
+                               .crc = nullptr };
   size_t enc_len{ 0u }, dec_len{ 0u };
   bool done{ false };
 
@@ -257,7 +258,21 @@ TEST_CASE("cobs_decode_inc: bad payload detection") {
     cobs_decode_inc_args_t args{ .enc_src = enc,
                                  .dec_dst = dec,
                                  .enc_src_max = sizeof(enc),
-                                 .dec_dst_max = sizeof(dec) };
+                                 .dec_dst_max = sizeof(dec),
+                                 .crc = nullptr };
+    REQUIRE(cobs_decode_inc(&ctx, &args, &enc_len, &dec_len, &done) ==
+            COBS_RET_ERR_BAD_PAYLOAD);
+  }
+
+  SUBCASE("interior zero in a later block") {
+    REQUIRE(cobs_decode_inc_begin(&ctx) == COBS_RET_SUCCESS);
+    // Two good blocks decode back to back, then code 0x03 runs into a zero
+    byte_t enc[] = { 0x02, 0x11, 0x02, 0x22, 0x03, 0x33, 0x00, 0x00 };
+    cobs_decode_inc_args_t args{ .enc_src = enc,
+                                 .dec_dst = dec,
+                                 .enc_src_max = sizeof(enc),
+                                 .dec_dst_max = sizeof(dec),
+                                 .crc = nullptr };
     REQUIRE(cobs_decode_inc(&ctx, &args, &enc_len, &dec_len, &done) ==
             COBS_RET_ERR_BAD_PAYLOAD);
   }
@@ -269,7 +284,8 @@ TEST_CASE("cobs_decode_inc: bad payload detection") {
     cobs_decode_inc_args_t args{ .enc_src = b0,
                                  .dec_dst = dec,
                                  .enc_src_max = 1,
-                                 .dec_dst_max = sizeof(dec) };
+                                 .dec_dst_max = sizeof(dec),
+                                 .crc = nullptr };
     REQUIRE(cobs_decode_inc(&ctx, &args, &enc_len, &dec_len, &done) == COBS_RET_SUCCESS);
     REQUIRE(!done);
 
@@ -0,0 +1,105 @@
+#include "../cobs.h"
+#include "byte_vec.h"
+#include "doctest_wrapper.h"
+
+#include <algorithm>
+#include <random>
+
+namespace {
+byte_vec_t encode(byte_vec_t const& dec) {
+  byte_vec_t enc(COBS_ENCODE_MAX(dec.size()));
+  size_t enc_len{ 0u };
+  byte_t const empty{ 0 };  // an empty vector's data() may be null
+  REQUIRE(cobs_encode(dec.empty() ? &empty : dec.data(),
+                      dec.size(),
+                      enc.data(),
+                      enc.size(),
+                      &enc_len) == COBS_RET_SUCCESS);
+  enc.resize(enc_len);
+  return enc;
+}
+
+byte_vec_t decode_inplace(byte_vec_t buf) {
+  size_t dec_len{ 0u };
+  REQUIRE(cobs_decode_inplace(buf.data(), buf.size(), &dec_len) == COBS_RET_SUCCESS);
+  buf.resize(dec_len);
+  return buf;
+}
+}  // namespace
+
+TEST_CASE("cobs_decode_inplace validation") {
+  byte_t buf[]{ 0x01, 0x00 };
+  size_t dec_len;
+
+  REQUIRE(cobs_decode_inplace(nullptr, 2, &dec_len) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_decode_inplace(buf, 2, nullptr) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_decode_inplace(buf, 0, &dec_len) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_decode_inplace(buf, 1, &dec_len) == COBS_RET_ERR_BAD_ARG);
+}
+
+TEST_CASE("cobs_decode_inplace") {
+  SUBCASE("Empty payload") {
+    REQUIRE(decode_inplace({ 0x01, 0x00 }).empty());
+  }
+
+  SUBCASE("Zeros between blocks") {
+    REQUIRE(decode_inplace({ 0x02, 0x11, 0x01, 0x03, 0x22, 0x33, 0x00 }) ==
+            byte_vec_t{ 0x11, 0x00, 0x00, 0x22, 0x33 });
+  }
+
+  SUBCASE("Full blocks") {
+    for (size_t const len : { 253u, 254u, 255u, 508u, 509u, 5000u }) {
+      byte_vec_t const dec(len, 0x42);
+      REQUIRE(decode_inplace(encode(dec)) == dec);
+    }
+  }
+
+  SUBCASE("Bytes after the delimiter are ignored") {
+    REQUIRE(decode_inplace({ 0x02, 0x11, 0x00, 0x05, 0x06 }) == byte_vec_t{ 0x11 });
+  }
+
+  SUBCASE("Bad payloads") {
+    size_t dec_len;
+    byte_t missing_delim[]{ 0x02, 0x11, 0x02, 0x22 };
+    REQUIRE(cobs_decode_inplace(missing_delim, sizeof(missing_delim), &dec_len) ==
+            COBS_RET_ERR_BAD_PAYLOAD);
+    byte_t zero_in_block[]{ 0x04, 0x11, 0x00, 0x22, 0x00 };
+    REQUIRE(cobs_decode_inplace(zero_in_block, sizeof(zero_in_block), &dec_len) ==
+            COBS_RET_ERR_BAD_PAYLOAD);
+    byte_t code_past_end[]{ 0x09, 0x11, 0x00 };
+    REQUIRE(cobs_decode_inplace(code_past_end, sizeof(code_past_end), &dec_len) ==
+            COBS_RET_ERR_BAD_PAYLOAD);
+  }
+}
+
+TEST_CASE("cobs_decode_inplace: random payloads match cobs_decode") {
+  std::mt19937 mt{ 97531u };
+  for (auto iter{ 0u }; iter < 1000; ++iter) {
+    byte_vec_t const dec{ random_payload(mt, mt() % 3000) };
+    byte_vec_t enc{ encode(dec) };
+    REQUIRE(decode_inplace(enc) == dec);
+
+    // Corrupt a byte; in-place decoding reaches the same verdict as cobs_decode.
+    enc[mt() % enc.size()] = byte_t((mt() % 2) ? mt() : 0);
+    byte_vec_t expected(enc.size());
+    size_t expected_len{ 0u }, actual_len{ 0u };
+    cobs_ret_t const expected_r{
+      cobs_decode(enc.data(), enc.size(), expected.data(), expected.size(), &expected_len)
+    };
+    byte_vec_t actual{ enc };
+    cobs_ret_t const actual_r{
+      cobs_decode_inplace(actual.data(), actual.size(), &actual_len)
+    };
+    if (expected_r == COBS_RET_ERR_EXHAUSTED) {  // no delimiter left
+      REQUIRE(actual_r == COBS_RET_ERR_BAD_PAYLOAD);
+    } else {
+      REQUIRE(actual_r == expected_r);
+    }
+    if (expected_r == COBS_RET_SUCCESS) {
+      REQUIRE(actual_len == expected_len);
+      REQUIRE(std::equal(actual.begin(),
+                         actual.begin() + static_cast<std::ptrdiff_t>(actual_len),
+                         expected.begin()));
+    }
+  }
+}
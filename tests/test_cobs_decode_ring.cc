@@ -0,0 +1,172 @@
+#include "../cobs.h"
+#include "byte_vec.h"
+#include "doctest_wrapper.h"
+
+#include <random>
+
+namespace {
+byte_vec_t encode(byte_vec_t const& dec) {
+  byte_vec_t enc(COBS_ENCODE_MAX(dec.size()));
+  size_t enc_len{ 0u };
+  byte_t const empty{ 0 };  // an empty vector's data() may be null
+  REQUIRE(cobs_encode(dec.empty() ? &empty : dec.data(),
+                      dec.size(),
+                      enc.data(),
+                      enc.size(),
+                      &enc_len) == COBS_RET_SUCCESS);
+  enc.resize(enc_len);
+  return enc;
+}
+
+// Appends as much of |bytes| from |pos| as fits in |ring|, returning the new |pos|.
+size_t ring_write(cobs_ring_t& ring, byte_vec_t const& bytes, size_t pos, size_t max) {
+  auto* const buf{ static_cast<byte_t*>(ring.buf) };
+  while ((pos < bytes.size()) && max-- && ((ring.tail + 1) % ring.cap != ring.head)) {
+    buf[ring.tail] = bytes[pos++];
+    ring.tail = (ring.tail + 1) % ring.cap;
+  }
+  return pos;
+}
+
+void ring_read_all(cobs_ring_t& ring, byte_vec_t& out) {
+  auto const* const buf{ static_cast<byte_t const*>(ring.buf) };
+  while (ring.head != ring.tail) {
+    out.push_back(buf[ring.head]);
+    ring.head = (ring.head + 1) % ring.cap;
+  }
+}
+}  // namespace
+
+TEST_CASE("cobs_decode_inc_ring validation") {
+  byte_t src_buf[8]{}, dst_buf[8]{};
+  cobs_ring_t src{ src_buf, sizeof(src_buf), 0, 0 };
+  cobs_ring_t dst{ dst_buf, sizeof(dst_buf), 0, 0 };
+  cobs_decode_inc_ctx_t ctx;
+  REQUIRE(cobs_decode_inc_begin(&ctx) == COBS_RET_SUCCESS);
+  size_t len;
+  bool complete;
+
+  cobs_decode_ring_args_t args{ &src, &dst, nullptr, 0, nullptr };
+  REQUIRE(cobs_decode_inc_ring(nullptr, &args, &len, &complete) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_decode_inc_ring(&ctx, nullptr, &len, &complete) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_decode_inc_ring(&ctx, &args, nullptr, &complete) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_decode_inc_ring(&ctx, &args, &len, nullptr) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_decode_inc_ring(&ctx, &args, &len, &complete) == COBS_RET_SUCCESS);
+  REQUIRE(len == 0);
+  REQUIRE(!complete);
+
+  SUBCASE("Missing source ring") {
+    args.enc_src = nullptr;
+    REQUIRE(cobs_decode_inc_ring(&ctx, &args, &len, &complete) == COBS_RET_ERR_BAD_ARG);
+  }
+  SUBCASE("Missing destination") {
+    args.dec_ring = nullptr;
+    REQUIRE(cobs_decode_inc_ring(&ctx, &args, &len, &complete) == COBS_RET_ERR_BAD_ARG);
+  }
+  SUBCASE("Index out of range") {
+    src.tail = sizeof(src_buf);
+    REQUIRE(cobs_decode_inc_ring(&ctx, &args, &len, &complete) == COBS_RET_ERR_BAD_ARG);
+  }
+  SUBCASE("Null ring buffer") {
+    dst.buf = nullptr;
+    REQUIRE(cobs_decode_inc_ring(&ctx, &args, &len, &complete) == COBS_RET_ERR_BAD_ARG);
+  }
+}
+
+TEST_CASE("cobs_decode_inc_ring") {
+  SUBCASE("Frame wrapping around the source ring, into a buffer") {
+    byte_t src_buf[6]{};
+    cobs_ring_t src{ src_buf, sizeof(src_buf), 4, 4 };
+    byte_vec_t const enc{ 0x02, 0x11, 0x02, 0x22, 0x00 };
+    REQUIRE(ring_write(src, enc, 0, enc.size()) == enc.size());
+    REQUIRE(src.tail == 3);
+
+    cobs_decode_inc_ctx_t ctx;
+    REQUIRE(cobs_decode_inc_begin(&ctx) == COBS_RET_SUCCESS);
+    byte_t out[8];
+    cobs_decode_ring_args_t const args{ &src, nullptr, out, sizeof(out), nullptr };
+    size_t len{ 0u };
+    bool complete{ false };
+    REQUIRE(cobs_decode_inc_ring(&ctx, &args, &len, &complete) == COBS_RET_SUCCESS);
+    REQUIRE(complete);
+    REQUIRE(byte_vec_t(out, out + len) == byte_vec_t{ 0x11, 0x00, 0x22 });
+    REQUIRE(src.head == src.tail);
+  }
+
+  SUBCASE("Bytes after the delimiter stay in the ring") {
+    byte_t src_buf[8]{};
+    cobs_ring_t src{ src_buf, sizeof(src_buf), 0, 0 };
+    byte_vec_t const enc{ 0x02, 0x11, 0x00, 0x02, 0x22, 0x00 };
+    ring_write(src, enc, 0, enc.size());
+
+    cobs_decode_inc_ctx_t ctx;
+    REQUIRE(cobs_decode_inc_begin(&ctx) == COBS_RET_SUCCESS);
+    byte_t out[8];
+    cobs_decode_ring_args_t const args{ &src, nullptr, out, sizeof(out), nullptr };
+    size_t len{ 0u };
+    bool complete{ false };
+    REQUIRE(cobs_decode_inc_ring(&ctx, &args, &len, &complete) == COBS_RET_SUCCESS);
+    REQUIRE(complete);
+    REQUIRE(len == 1);
+    REQUIRE(src.head == 3);
+  }
+
+  SUBCASE("Bad payload") {
+    byte_t src_buf[8]{};
+    cobs_ring_t src{ src_buf, sizeof(src_buf), 6, 6 };
+    byte_vec_t const enc{ 0x04, 0x11, 0x00, 0x22, 0x00 };
+    ring_write(src, enc, 0, enc.size());
+
+    cobs_decode_inc_ctx_t ctx;
+    REQUIRE(cobs_decode_inc_begin(&ctx) == COBS_RET_SUCCESS);
+    byte_t out[8];
+    cobs_decode_ring_args_t const args{ &src, nullptr, out, sizeof(out), nullptr };
+    size_t len;
+    bool complete;
+    REQUIRE(cobs_decode_inc_ring(&ctx, &args, &len, &complete) ==
+            COBS_RET_ERR_BAD_PAYLOAD);
+  }
+}
+
+TEST_CASE("cobs_decode_inc_ring: random frames through small rings") {
+  std::mt19937 mt{ 60221u };
+  for (auto iter{ 0u }; iter < 500; ++iter) {
+    byte_vec_t const dec{ random_payload(mt, mt() % 1500) };
+    byte_vec_t const enc{ encode(dec) };
+
+    // Rings smaller than the frame, starting anywhere, fed and drained in random chunks.
+    byte_vec_t src_buf(2 + (mt() % 300)), dst_buf(2 + (mt() % 300));
+    size_t const src_start{ mt() % src_buf.size() }, dst_start{ mt() % dst_buf.size() };
+    cobs_ring_t src{ src_buf.data(), src_buf.size(), src_start, src_start };
+    cobs_ring_t dst{ dst_buf.data(), dst_buf.size(), dst_start, dst_start };
+    bool const to_ring{ (mt() % 2) != 0 };
+    byte_vec_t linear(dec.size() + 1);
+
+    cobs_decode_inc_ctx_t ctx;
+    REQUIRE(cobs_decode_inc_begin(&ctx) == COBS_RET_SUCCESS);
+    byte_vec_t out;
+    size_t enc_pos{ 0u };
+    bool complete{ false };
+    while (!complete) {
+      enc_pos = ring_write(src, enc, enc_pos, 1 + (mt() % 400));
+      cobs_decode_ring_args_t const args{ &src,
+                                          to_ring ? &dst : nullptr,
+                                          linear.data() + out.size(),
+                                          linear.size() - out.size(),
+                                          nullptr };
+      size_t len{ 0u };
+      REQUIRE(cobs_decode_inc_ring(&ctx, &args, &len, &complete) == COBS_RET_SUCCESS);
+      if (to_ring) {
+        size_t const before{ out.size() };
+        ring_read_all(dst, out);
+        REQUIRE(out.size() - before == len);
+      } else {
+        out.insert(out.end(), linear.begin() + static_cast<std::ptrdiff_t>(out.size()),
+                   linear.begin() + static_cast<std::ptrdiff_t>(out.size() + len));
+      }
+    }
+    REQUIRE(out == dec);
+    REQUIRE(enc_pos == enc.size());
+    REQUIRE(src.head == src.tail);
+  }
+}
@@ -0,0 +1,143 @@
+#include "../cobs.h"
+#include "byte_vec.h"
+#include "doctest_wrapper.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+byte_vec_t encode(byte_vec_t const& dec) {
+  byte_vec_t enc(COBS_ENCODE_MAX(dec.size()));
+  size_t enc_len{ 0u };
+  byte_t const empty{ 0 };  // an empty vector's data() may be null
+  REQUIRE(cobs_encode(dec.empty() ? &empty : dec.data(),
+                      dec.size(),
+                      enc.data(),
+                      enc.size(),
+                      &enc_len) == COBS_RET_SUCCESS);
+  enc.resize(enc_len);
+  return enc;
+}
+
+// Decodes |enc| with cobs_decode into |dec_max| bytes, and with cobs_decode_scatter into
+// the same amount of space split at |cuts|, which must be sorted, and checks they agree.
+cobs_ret_t require_same(byte_vec_t const& enc,
+                        size_t dec_max,
+                        std::vector<size_t> const& cuts) {
+  byte_vec_t expected(std::max<size_t>(dec_max, 1)), actual(expected.size());
+  size_t expected_len{ 0 }, actual_len{ 0 };
+  cobs_ret_t const expected_ret{
+    cobs_decode(enc.data(), enc.size(), expected.data(), dec_max, &expected_len)
+  };
+
+  std::vector<cobs_dst_seg_t> segs;
+  size_t prev{ 0 };
+  for (size_t const cut : cuts) {
+    segs.push_back({ actual.data() + prev, cut - prev });
+    prev = cut;
+  }
+  segs.push_back({ actual.data() + prev, dec_max - prev });
+
+  REQUIRE(cobs_decode_scatter(enc.data(),
+                              enc.size(),
+                              segs.data(),
+                              segs.size(),
+                              &actual_len) == expected_ret);
+  if (expected_ret != COBS_RET_ERR_BAD_PAYLOAD) {
+    REQUIRE(actual_len == expected_len);
+    REQUIRE(std::equal(expected.begin(),
+                       expected.begin() + static_cast<std::ptrdiff_t>(expected_len),
+                       actual.begin()));
+  }
+  return expected_ret;
+}
+}  // namespace
+
+TEST_CASE("cobs_decode_scatter validation") {
+  byte_t enc[]{ 0x02, 0x11, 0x00 }, dec[4];
+  cobs_dst_seg_t const segs[]{ { dec, 2 }, { dec + 2, 2 } };
+  size_t dec_len;
+
+  REQUIRE(cobs_decode_scatter(nullptr, 3, segs, 2, &dec_len) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_decode_scatter(enc, 3, nullptr, 2, &dec_len) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_decode_scatter(enc, 3, segs, 2, nullptr) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_decode_scatter(enc, 1, segs, 2, &dec_len) == COBS_RET_ERR_BAD_ARG);
+
+  cobs_dst_seg_t const null_seg[]{ { dec, 2 }, { nullptr, 2 } };
+  REQUIRE(cobs_decode_scatter(enc, 3, null_seg, 2, &dec_len) == COBS_RET_ERR_BAD_ARG);
+
+  cobs_dst_seg_t const empty_null_seg[]{ { nullptr, 0 }, { dec, 1 } };
+  REQUIRE(cobs_decode_scatter(enc, 3, empty_null_seg, 2, &dec_len) == COBS_RET_SUCCESS);
+  REQUIRE(dec_len == 1);
+  REQUIRE(dec[0] == 0x11);
+}
+
+TEST_CASE("cobs_decode_scatter") {
+  SUBCASE("Header and body") {
+    struct {
+      byte_t type, flags;
+    } header;
+    byte_t body[16];
+    byte_vec_t const enc{ encode({ 0x07, 0x00, 0xAA, 0x00, 0xBB }) };
+    cobs_dst_seg_t const segs[]{ { &header, sizeof(header) }, { body, sizeof(body) } };
+    size_t dec_len;
+    REQUIRE(cobs_decode_scatter(enc.data(), enc.size(), segs, 2, &dec_len) ==
+            COBS_RET_SUCCESS);
+    REQUIRE(dec_len == 5);
+    REQUIRE(header.type == 0x07);
+    REQUIRE(header.flags == 0x00);
+    REQUIRE(byte_vec_t(body, body + 3) == byte_vec_t{ 0xAA, 0x00, 0xBB });
+  }
+
+  SUBCASE("No segments") {
+    byte_vec_t const enc{ encode({}) };
+    size_t dec_len{ 1 };
+    cobs_dst_seg_t const seg{ nullptr, 0 };
+    REQUIRE(cobs_decode_scatter(enc.data(), enc.size(), &seg, 0, &dec_len) ==
+            COBS_RET_SUCCESS);
+    REQUIRE(dec_len == 0);
+    REQUIRE(require_same(encode({ 0x11 }), 0, {}) == COBS_RET_ERR_EXHAUSTED);
+  }
+
+  SUBCASE("Empty segments anywhere") {
+    REQUIRE(require_same(encode({ 0x11, 0x00, 0x22 }), 3, { 0, 0, 1, 1, 3 }) ==
+            COBS_RET_SUCCESS);
+  }
+
+  SUBCASE("Blocks and zeros straddle segments") {
+    for (size_t const len : { 253u, 254u, 255u, 508u }) {
+      byte_vec_t dec(len, 0x42);
+      dec.push_back(0);
+      dec.push_back(0x43);
+      byte_vec_t const enc{ encode(dec) };
+      for (size_t cut{ 0 }; cut <= dec.size(); ++cut) {
+        REQUIRE(require_same(enc, dec.size(), { cut }) == COBS_RET_SUCCESS);
+        REQUIRE(require_same(enc, dec.size() - 1, { std::min(cut, dec.size() - 1) }) ==
+                COBS_RET_ERR_EXHAUSTED);
+      }
+    }
+  }
+}
+
+TEST_CASE("cobs_decode_scatter: random frames, cuts and corruption") {
+  std::mt19937 mt{ 24680u };
+  for (auto iter{ 0u }; iter < 1000; ++iter) {
+    byte_vec_t const dec{ random_payload(mt, mt() % 1500) };
+    byte_vec_t enc{ encode(dec) };
+    switch (mt() % 4) {
+      case 0: enc[mt() % enc.size()] = byte_t(mt()); break;  // maybe corrupt
+      case 1: enc.pop_back(); break;                         // missing delimiter
+      default: break;
+    }
+    if (enc.size() < 2) {
+      continue;
+    }
+
+    size_t const dec_max{ dec.size() + 2 - (mt() % 4) };
+    std::vector<size_t> cuts(mt() % 8);
+    std::generate(cuts.begin(), cuts.end(), [&]() { return mt() % (dec_max + 1); });
+    std::sort(cuts.begin(), cuts.end());
+    require_same(enc, dec_max, cuts);
+  }
+}
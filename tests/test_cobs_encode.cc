@@ -385,3 +385,16 @@ TEST_CASE("Encode: round-trip encode/decode") {
     }
   }
 }
+
+TEST_CASE("Encode: zero at every offset across vector widths") {
+  for (size_t len{ 1 }; len <= 300; ++len) {
+    for (size_t zero_at{ 0 }; zero_at < len; ++zero_at) {
+      byte_vec_t dec(len, 0x5A);
+      dec[zero_at] = 0x00;
+      byte_vec_t const enc = encode(dec);
+      verify_frame_invariants(enc);
+      REQUIRE(enc[0] == byte_t(zero_at < 254 ? zero_at + 1 : 0xFF));
+      REQUIRE(decode(enc) == dec);
+    }
+  }
+}
@@ -0,0 +1,118 @@
+#include "../cobs.h"
+#include "byte_vec.h"
+#include "doctest_wrapper.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+struct result {
+  cobs_ret_t ret;
+  byte_vec_t enc;
+};
+
+result encode(byte_vec_t const& dec, size_t enc_max) {
+  result r{ COBS_RET_SUCCESS, byte_vec_t(std::max<size_t>(enc_max, 1)) };
+  size_t enc_len{ 0u };
+  byte_t const empty{ 0 };  // an empty vector's data() may be null
+  r.ret = cobs_encode(dec.empty() ? &empty : dec.data(),
+                      dec.size(),
+                      r.enc.data(),
+                      enc_max,
+                      &enc_len);
+  r.enc.resize(r.ret == COBS_RET_SUCCESS ? enc_len : 0);
+  return r;
+}
+
+// Gathers |dec| split into pieces at |cuts|, which must be sorted.
+result encode_gather(byte_vec_t const& dec, std::vector<size_t> const& cuts, size_t enc_max) {
+  std::vector<cobs_src_seg_t> segs;
+  size_t prev{ 0 };
+  for (size_t const cut : cuts) {
+    segs.push_back({ dec.data() + prev, cut - prev });
+    prev = cut;
+  }
+  segs.push_back({ dec.data() + prev, dec.size() - prev });
+
+  result r{ COBS_RET_SUCCESS, byte_vec_t(std::max<size_t>(enc_max, 1)) };
+  size_t enc_len{ 0u };
+  r.ret = cobs_encode_gather(segs.data(), segs.size(), r.enc.data(), enc_max, &enc_len);
+  r.enc.resize(r.ret == COBS_RET_SUCCESS ? enc_len : 0);
+  return r;
+}
+
+void require_same(byte_vec_t const& dec, std::vector<size_t> const& cuts) {
+  size_t const enc_max{ COBS_ENCODE_MAX(dec.size()) };
+  result const expected{ encode(dec, enc_max) };
+  REQUIRE(expected.ret == COBS_RET_SUCCESS);
+  result const actual{ encode_gather(dec, cuts, enc_max) };
+  REQUIRE(actual.ret == COBS_RET_SUCCESS);
+  REQUIRE(actual.enc == expected.enc);
+
+  // Both run out of room at the same point.
+  REQUIRE(encode_gather(dec, cuts, expected.enc.size()).ret == COBS_RET_SUCCESS);
+  REQUIRE(encode_gather(dec, cuts, expected.enc.size() - 1).ret == COBS_RET_ERR_EXHAUSTED);
+}
+}  // namespace
+
+TEST_CASE("cobs_encode_gather validation") {
+  byte_t dec[4]{}, enc[16];
+  cobs_src_seg_t const segs[]{ { dec, 2 }, { dec + 2, 2 } };
+  size_t enc_len;
+
+  REQUIRE(cobs_encode_gather(nullptr, 2, enc, 16, &enc_len) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_encode_gather(segs, 2, nullptr, 16, &enc_len) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_encode_gather(segs, 2, enc, 16, nullptr) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_encode_gather(segs, 2, enc, 1, &enc_len) == COBS_RET_ERR_BAD_ARG);
+
+  cobs_src_seg_t const null_seg[]{ { dec, 2 }, { nullptr, 2 } };
+  REQUIRE(cobs_encode_gather(null_seg, 2, enc, 16, &enc_len) == COBS_RET_ERR_BAD_ARG);
+
+  cobs_src_seg_t const empty_null_seg[]{ { nullptr, 0 }, { dec, 1 } };
+  REQUIRE(cobs_encode_gather(empty_null_seg, 2, enc, 16, &enc_len) == COBS_RET_SUCCESS);
+  REQUIRE(byte_vec_t(enc, enc + enc_len) == byte_vec_t{ 0x01, 0x01, 0x00 });
+}
+
+TEST_CASE("cobs_encode_gather") {
+  SUBCASE("No segments") {
+    byte_t enc[2];
+    size_t enc_len;
+    cobs_src_seg_t const seg{ nullptr, 0 };
+    REQUIRE(cobs_encode_gather(&seg, 0, enc, 2, &enc_len) == COBS_RET_SUCCESS);
+    REQUIRE(byte_vec_t(enc, enc + enc_len) == byte_vec_t{ 0x01, 0x00 });
+  }
+
+  SUBCASE("Header, payload and trailer") {
+    require_same({ 0xAA, 0x00, 0x11, 0x22, 0x00, 0x33, 0x00, 0xBB }, { 2, 6 });
+  }
+
+  SUBCASE("Empty segments anywhere") {
+    require_same({ 0x11, 0x00, 0x22 }, { 0, 0, 1, 1, 3, 3 });
+  }
+
+  SUBCASE("Full blocks straddle segments") {
+    for (size_t const len : { 253u, 254u, 255u, 508u, 509u }) {
+      byte_vec_t dec(len, 0x42);
+      for (size_t cut{ 0 }; cut <= len; ++cut) {
+        require_same(dec, { cut });
+      }
+      dec.push_back(0);
+      for (size_t cut{ 0 }; cut <= len + 1; ++cut) {
+        require_same(dec, { cut });
+      }
+    }
+  }
+}
+
+TEST_CASE("cobs_encode_gather: random payloads and cuts") {
+  std::mt19937 mt{ 13579u };
+  for (auto iter{ 0u }; iter < 500; ++iter) {
+    byte_vec_t const dec{ random_payload(mt, mt() % 2000) };
+
+    std::vector<size_t> cuts(mt() % 8);
+    std::generate(cuts.begin(), cuts.end(), [&]() { return mt() % (dec.size() + 1); });
+    std::sort(cuts.begin(), cuts.end());
+    require_same(dec, cuts);
+  }
+}
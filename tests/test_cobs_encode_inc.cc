@@ -320,6 +320,52 @@ TEST_CASE("cobs_encode_inc") {
     REQUIRE(enc_buf[3] == 0x22);
     REQUIRE(ctx.state == cobs_enc_ctx_t::COBS_ENCODE_ACCUMULATE);
   }
+
+  SUBCASE("whole blocks bypass the work buffer") {
+    std::fill(work_buf.begin(), work_buf.end(), byte_t{ 0xCC });
+    dec_buf[0] = 0x11;
+    dec_buf[1] = 0x00;
+    std::fill(dec_buf.begin() + 2, dec_buf.begin() + 256, byte_t{ 0x22 });
+    size_t src_len{}, dst_len{};
+    cobs_encode_inc_args_t args{};
+    args.dec_src = dec_buf.data();
+    args.enc_dst = enc_buf.data();
+    args.dec_src_max = 256;
+    args.enc_dst_max = 1024;
+    REQUIRE(cobs_encode_inc(&ctx, &args, &src_len, &dst_len) == COBS_RET_SUCCESS);
+    REQUIRE(src_len == 256);
+    REQUIRE(dst_len == 257);  // [0x02, 0x11], [0xFF, 0x22 x 254]
+    REQUIRE(enc_buf[0] == 0x02);
+    REQUIRE(enc_buf[2] == 0xFF);
+    REQUIRE(std::count(work_buf.begin(), work_buf.end(), byte_t{ 0xCC }) == 255);
+    REQUIRE(ctx.prev_was_ff == 1);
+  }
+
+  SUBCASE("block straddling calls is staged in the work buffer") {
+    dec_buf[0] = 0x11;
+    dec_buf[1] = 0x22;
+    dec_buf[2] = 0x00;
+    size_t src_len{}, dst_len{};
+    cobs_encode_inc_args_t args{};
+    args.dec_src = dec_buf.data();
+    args.enc_dst = enc_buf.data();
+    args.dec_src_max = 1;
+    args.enc_dst_max = 1024;
+    REQUIRE(cobs_encode_inc(&ctx, &args, &src_len, &dst_len) == COBS_RET_SUCCESS);
+    REQUIRE(src_len == 1);
+    REQUIRE(dst_len == 0);
+    REQUIRE(work_buf[1] == 0x11);
+
+    args.dec_src = dec_buf.data() + 1;
+    args.dec_src_max = 2;
+    REQUIRE(cobs_encode_inc(&ctx, &args, &src_len, &dst_len) == COBS_RET_SUCCESS);
+    REQUIRE(src_len == 2);
+    REQUIRE(dst_len == 3);
+    REQUIRE(enc_buf[0] == 0x03);
+    REQUIRE(enc_buf[1] == 0x11);
+    REQUIRE(enc_buf[2] == 0x22);
+    REQUIRE(ctx.state == cobs_enc_ctx_t::COBS_ENCODE_ACCUMULATE);
+  }
 }
 
 TEST_CASE("cobs_encode_inc_end") {
@@ -0,0 +1,74 @@
+#include "../cobs.h"
+#include "byte_vec.h"
+#include "doctest_wrapper.h"
+
+#include <random>
+
+namespace {
+byte_vec_t encode(byte_vec_t const& dec) {
+  byte_vec_t enc(COBS_ENCODE_MAX(dec.size()));
+  size_t enc_len{ 0u };
+  byte_t const empty{ 0 };  // an empty vector's data() may be null
+  REQUIRE(cobs_encode(dec.empty() ? &empty : dec.data(),
+                      dec.size(),
+                      enc.data(),
+                      enc.size(),
+                      &enc_len) == COBS_RET_SUCCESS);
+  enc.resize(enc_len);
+  return enc;
+}
+
+byte_vec_t encode_inplace(byte_vec_t const& dec, size_t slack = 0) {
+  byte_vec_t buf{ dec };
+  buf.resize(COBS_ENCODE_MAX(dec.size()) + slack, 0xAA);
+  size_t enc_len{ 0u };
+  REQUIRE(cobs_encode_inplace(buf.data(), dec.size(), buf.size(), &enc_len) ==
+          COBS_RET_SUCCESS);
+  buf.resize(enc_len);
+  return buf;
+}
+}  // namespace
+
+TEST_CASE("cobs_encode_inplace validation") {
+  byte_t buf[8]{};
+  size_t enc_len;
+
+  REQUIRE(cobs_encode_inplace(nullptr, 0, 8, &enc_len) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_encode_inplace(buf, 0, 8, nullptr) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_encode_inplace(buf, 0, 1, &enc_len) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_encode_inplace(buf, 7, 8, &enc_len) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_encode_inplace(buf, 9, 8, &enc_len) == COBS_RET_ERR_BAD_ARG);
+
+  // Exactly COBS_ENCODE_MAX is enough, even for a payload that wouldn't need all of it.
+  REQUIRE(cobs_encode_inplace(buf, 6, 8, &enc_len) == COBS_RET_SUCCESS);
+  REQUIRE(cobs_encode_inplace(buf, 0, 2, &enc_len) == COBS_RET_SUCCESS);
+}
+
+TEST_CASE("cobs_encode_inplace") {
+  SUBCASE("Empty payload") {
+    REQUIRE(encode_inplace({}) == byte_vec_t{ 0x01, 0x00 });
+  }
+
+  SUBCASE("Zeros") {
+    REQUIRE(encode_inplace({ 0x00, 0x00 }) == byte_vec_t{ 0x01, 0x01, 0x01, 0x00 });
+    REQUIRE(encode_inplace({ 0x11, 0x00, 0x22 }) ==
+            byte_vec_t{ 0x02, 0x11, 0x02, 0x22, 0x00 });
+  }
+
+  SUBCASE("Block boundaries, with and without extra slack") {
+    for (size_t const len : { 253u, 254u, 255u, 508u, 509u, 1u << 20 }) {
+      byte_vec_t const dec(len, 0x42);
+      REQUIRE(encode_inplace(dec) == encode(dec));
+      REQUIRE(encode_inplace(dec, 1) == encode(dec));
+      REQUIRE(encode_inplace(dec, 3000) == encode(dec));
+    }
+  }
+}
+
+TEST_CASE("cobs_encode_inplace: random payloads match cobs_encode") {
+  std::mt19937 mt{ 24680u };
+  for (auto iter{ 0u }; iter < 1000; ++iter) {
+    byte_vec_t const dec{ random_payload(mt, mt() % 3000) };
+    REQUIRE(encode_inplace(dec, mt() % 8) == encode(dec));
+  }
+}
@@ -0,0 +1,68 @@
+#include "../cobs.h"
+#include "byte_vec.h"
+#include "doctest_wrapper.h"
+
+#include <random>
+
+namespace {
+size_t encode_len(byte_vec_t const& dec) {
+  byte_vec_t enc(COBS_ENCODE_MAX(dec.size()));
+  size_t enc_len{ 0u };
+  byte_t const empty{ 0 };  // an empty vector's data() may be null
+  REQUIRE(cobs_encode(dec.empty() ? &empty : dec.data(),
+                      dec.size(),
+                      enc.data(),
+                      enc.size(),
+                      &enc_len) == COBS_RET_SUCCESS);
+  return enc_len;
+}
+
+size_t encoded_len(byte_vec_t const& dec) {
+  size_t enc_len{ 0u };
+  byte_t const empty{ 0 };
+  REQUIRE(cobs_encoded_len(dec.empty() ? &empty : dec.data(), dec.size(), &enc_len) ==
+          COBS_RET_SUCCESS);
+  return enc_len;
+}
+}  // namespace
+
+TEST_CASE("cobs_encoded_len validation") {
+  byte_t const dec{ 0x11 };
+  size_t enc_len;
+  REQUIRE(cobs_encoded_len(nullptr, 1, &enc_len) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_encoded_len(&dec, 1, nullptr) == COBS_RET_ERR_BAD_ARG);
+}
+
+TEST_CASE("cobs_encoded_len") {
+  SUBCASE("Small payloads") {
+    REQUIRE(encoded_len({}) == 2);
+    REQUIRE(encoded_len({ 0x00 }) == 3);
+    REQUIRE(encoded_len({ 0x11 }) == 3);
+    REQUIRE(encoded_len({ 0x00, 0x00 }) == 4);
+    REQUIRE(encoded_len({ 0x11, 0x00, 0x22 }) == 5);
+  }
+
+  SUBCASE("Block boundaries") {
+    for (size_t const len : { 253u, 254u, 255u, 507u, 508u, 509u, 100000u }) {
+      byte_vec_t dec(len, 0x42);
+      REQUIRE(encoded_len(dec) == encode_len(dec));
+      dec.back() = 0x00;  // a zero right after a full block
+      REQUIRE(encoded_len(dec) == encode_len(dec));
+      dec.push_back(0x00);
+      REQUIRE(encoded_len(dec) == encode_len(dec));
+    }
+  }
+
+  SUBCASE("Never exceeds COBS_ENCODE_MAX") {
+    byte_vec_t const dec(1000, 0x01);
+    REQUIRE(encoded_len(dec) == COBS_ENCODE_MAX(dec.size()));
+  }
+}
+
+TEST_CASE("cobs_encoded_len: random payloads match cobs_encode") {
+  std::mt19937 mt{ 13579u };
+  for (auto iter{ 0u }; iter < 2000; ++iter) {
+    byte_vec_t const dec{ random_payload(mt, mt() % 3000) };
+    REQUIRE(encoded_len(dec) == encode_len(dec));
+  }
+}
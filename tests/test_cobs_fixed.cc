@@ -0,0 +1,215 @@
+#include "../cobs_fixed.h"
+#include "byte_vec.h"
+#include "doctest_wrapper.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+namespace {
+constexpr std::array s_abc{ std::byte{ 0x11 }, std::byte{ 0x00 }, std::byte{ 0x22 } };
+constexpr auto s_abc_enc{ cobs::encode(std::span{ s_abc }) };
+static_assert(s_abc_enc.len == 5);
+static_assert(s_abc_enc.buf[0] == std::byte{ 0x02 });
+static_assert(s_abc_enc.buf[2] == std::byte{ 0x02 });
+static_assert(s_abc_enc.buf[4] == std::byte{ 0x00 });
+
+// Long enough for a full 0xFF block, and for the run-time path to use cobs_encode instead.
+constexpr auto s_big{ [] {
+  std::array<std::byte, 600> a{};
+  for (size_t i{ 0 }; i < a.size(); ++i) {
+    a[i] = ((i < 300) || (i % 7)) ? std::byte(i % 255 + 1) : std::byte{ 0 };
+  }
+  return a;
+}() };
+constexpr auto s_big_enc{ cobs::encode(std::span{ s_big }) };
+static_assert(s_big_enc.buf[0] == std::byte{ 0xFF });
+static_assert([] {
+  std::array<std::byte, 600> out{};
+  return (cobs::decode(s_big_enc.bytes(), std::span{ out }) == COBS_RET_SUCCESS) &&
+         (out == s_big);
+}());
+
+constexpr auto s_ping{ cobs::frame_constant<cobs::bytes<0x01, 0x00>> };
+static_assert(s_ping == cobs::bytes<0x02, 0x01, 0x01, 0x00>);
+constexpr auto s_hello{ cobs::frame_constant<cobs::text("HELLO")> };
+static_assert(s_hello.size() == 7);
+static_assert(cobs::payload_constant<s_hello> == cobs::text("HELLO"));
+static_assert(cobs::frame_constant<cobs::bytes<>> == cobs::bytes<0x01, 0x00>);
+static_assert(cobs::payload_constant<cobs::bytes<0x01, 0x00>>.empty());
+static_assert(cobs::payload_constant<cobs::bytes<0x02, 0x11, 0x00, 0x55>> ==
+              cobs::bytes<0x11>);
+static_assert(cobs::payload_constant<cobs::frame_constant<s_big>> == s_big);
+
+byte_vec_t encode(byte_vec_t const& dec) {
+  byte_vec_t enc(COBS_ENCODE_MAX(dec.size()));
+  size_t enc_len{ 0u };
+  byte_t const empty{ 0 };  // an empty vector's data() may be null
+  REQUIRE(cobs_encode(dec.empty() ? &empty : dec.data(),
+                      dec.size(),
+                      enc.data(),
+                      enc.size(),
+                      &enc_len) == COBS_RET_SUCCESS);
+  enc.resize(enc_len);
+  return enc;
+}
+
+template <size_t N>
+void round_trip(byte_vec_t const& dec) {
+  REQUIRE(dec.size() == N);
+  std::array<std::byte, N> in{};
+  for (size_t i{ 0 }; i < N; ++i) {
+    in[i] = std::byte(dec[i]);
+  }
+  auto const f{ cobs::encode(std::span<std::byte const, N>{ in }) };
+  if constexpr (N < 255) {
+    REQUIRE(f.len == f.buf.size());
+  }
+
+  byte_vec_t const expected{ encode(dec) };
+  REQUIRE(f.size() == expected.size());
+  REQUIRE(std::memcmp(f.data(), expected.data(), f.size()) == 0);
+
+  std::array<std::byte, N> out{};
+  REQUIRE(cobs::decode(f.bytes(), std::span{ out }) == COBS_RET_SUCCESS);
+  REQUIRE(out == in);
+}
+
+template <size_t N>
+void round_trip_patterns() {
+  std::mt19937 mt{ unsigned(N) };
+  byte_vec_t dec(N);
+  for (auto zeros : { 0u, 1u, 4u, 128u, 256u }) {  // 1 in |zeros| bytes are zero
+    std::generate(dec.begin(), dec.end(), [&]() {
+      return (zeros && !(mt() % zeros)) ? byte_t{ 0 } : byte_t(mt() | 1);
+    });
+    round_trip<N>(dec);
+  }
+}
+
+// Decodes |Frame| into |N| bytes at compile time, at run time, and with cobs_decode, which
+// must all agree. Past fixed_inline_max, the run-time path is cobs_decode itself.
+template <size_t N, auto const& Frame>
+void decode_agrees() {
+  constexpr cobs_ret_t at_compile_time{ [] {
+    std::array<std::byte, N> out{};
+    return cobs::decode(std::span{ Frame }, std::span{ out });
+  }() };
+  std::array<std::byte, N> out{};
+  REQUIRE(cobs::decode(std::span{ Frame }, std::span{ out }) == at_compile_time);
+
+  std::array<std::byte, N + 1> buf{};
+  size_t dec_len;
+  cobs_ret_t r{ cobs_decode(Frame.data(), Frame.size(), buf.data(), N, &dec_len) };
+  if ((r == COBS_RET_SUCCESS) && (dec_len != N)) {
+    r = COBS_RET_ERR_BAD_PAYLOAD;
+  }
+  REQUIRE(r == at_compile_time);
+}
+
+template <auto const& Frame>
+cobs_ret_t decode_agrees_around_inline_max() {
+  decode_agrees<1, Frame>();
+  decode_agrees<8, Frame>();
+  decode_agrees<cobs::detail::fixed_inline_max, Frame>();
+  decode_agrees<cobs::detail::fixed_inline_max + 1, Frame>();
+  decode_agrees<40, Frame>();
+  std::array<std::byte, 40> out{};
+  return cobs::decode(std::span{ Frame }, std::span{ out });
+}
+}  // namespace
+
+TEST_CASE("cobs::encode and cobs::decode match cobs_encode and cobs_decode") {
+  round_trip_patterns<0>();
+  round_trip_patterns<1>();
+  round_trip_patterns<2>();
+  round_trip_patterns<16>();
+  round_trip_patterns<253>();
+  round_trip_patterns<254>();
+  round_trip_patterns<255>();
+  round_trip_patterns<508>();
+  round_trip_patterns<509>();
+  round_trip_patterns<1500>();
+}
+
+TEST_CASE("cobs::encode at compile time matches cobs_encode") {
+  byte_vec_t dec(s_big.size());
+  std::memcpy(dec.data(), s_big.data(), dec.size());
+  byte_vec_t const expected{ encode(dec) };
+  REQUIRE(s_big_enc.size() == expected.size());
+  REQUIRE(std::memcmp(s_big_enc.data(), expected.data(), expected.size()) == 0);
+}
+
+TEST_CASE("cobs::frame_constant matches cobs_encode") {
+  auto const check{ [](auto const& frame, byte_vec_t const& dec) {
+    byte_vec_t const expected{ encode(dec) };
+    REQUIRE(frame.size() == expected.size());
+    REQUIRE(std::memcmp(frame.data(), expected.data(), expected.size()) == 0);
+  } };
+
+  check(cobs::frame_constant<cobs::bytes<>>, {});
+  check(s_ping, { 0x01, 0x00 });
+  check(s_hello, { 'H', 'E', 'L', 'L', 'O' });
+
+  byte_vec_t big(s_big.size());
+  std::memcpy(big.data(), s_big.data(), big.size());
+  check(cobs::frame_constant<s_big>, big);
+}
+
+TEST_CASE("cobs::decode") {
+  std::array<std::byte, 2> out{};
+  auto const dec{ [&](byte_vec_t const& enc) {
+    return cobs::decode(std::as_bytes(std::span{ enc }), std::span{ out });
+  } };
+
+  SUBCASE("Exact length") {
+    REQUIRE(dec({ 0x02, 0x11, 0x02, 0x22, 0x00 }) == COBS_RET_ERR_EXHAUSTED);
+    REQUIRE(dec({ 0x03, 0x11, 0x22, 0x00 }) == COBS_RET_SUCCESS);
+    REQUIRE(out == std::array{ std::byte{ 0x11 }, std::byte{ 0x22 } });
+    REQUIRE(dec({ 0x02, 0x11, 0x00 }) == COBS_RET_ERR_BAD_PAYLOAD);
+  }
+
+  SUBCASE("Bytes after the delimiter are ignored") {
+    REQUIRE(dec({ 0x01, 0x02, 0x11, 0x00, 0x55 }) == COBS_RET_SUCCESS);
+    REQUIRE(out == std::array{ std::byte{ 0x00 }, std::byte{ 0x11 } });
+  }
+
+  SUBCASE("Malformed frames") {
+    REQUIRE(dec({}) == COBS_RET_ERR_BAD_ARG);
+    REQUIRE(dec({ 0x00 }) == COBS_RET_ERR_BAD_ARG);
+    REQUIRE(dec({ 0x00, 0x00 }) == COBS_RET_ERR_BAD_PAYLOAD);
+    REQUIRE(dec({ 0x03, 0x11, 0x22 }) == COBS_RET_ERR_EXHAUSTED);  // no delimiter
+    REQUIRE(dec({ 0x03, 0x11, 0x00, 0x00 }) == COBS_RET_ERR_BAD_PAYLOAD);
+  }
+
+  SUBCASE("Same result at compile time and run time, either side of the inline limit") {
+    using cobs::bytes;
+    REQUIRE(decode_agrees_around_inline_max<bytes<0x05, 'a', 0x00>>() ==
+            COBS_RET_ERR_BAD_PAYLOAD);
+    REQUIRE(decode_agrees_around_inline_max<bytes<0x09, 0x11, 0x00, 0x22>>() ==
+            COBS_RET_ERR_BAD_PAYLOAD);
+    REQUIRE(decode_agrees_around_inline_max<bytes<0x00, 0x11, 0x00>>() ==
+            COBS_RET_ERR_BAD_PAYLOAD);
+    REQUIRE(decode_agrees_around_inline_max<bytes<0x03, 0x11, 0x22>>() ==
+            COBS_RET_ERR_EXHAUSTED);
+    REQUIRE(decode_agrees_around_inline_max<bytes<0x02, 0x11, 0x02>>() ==
+            COBS_RET_ERR_EXHAUSTED);
+    REQUIRE(decode_agrees_around_inline_max<bytes<0x03, 0x11, 0x22, 0x00>>() ==
+            COBS_RET_ERR_BAD_PAYLOAD);
+  }
+
+  SUBCASE("Agrees with cobs_validate on random frames") {
+    std::mt19937 mt{ 1234 };
+    for (auto i{ 0u }; i < 20000; ++i) {
+      byte_vec_t enc(2 + (mt() % 6));
+      std::generate(enc.begin(), enc.end(), [&]() { return byte_t(mt() % 4); });
+      enc.back() = 0;
+
+      size_t dec_len, err_ofs;
+      bool const valid{ (cobs_validate(enc.data(), enc.size(), &dec_len, &err_ofs) ==
+                         COBS_RET_SUCCESS) &&
+                        (dec_len == out.size()) };
+      REQUIRE((dec(enc) == COBS_RET_SUCCESS) == valid);
+    }
+  }
+}
@@ -0,0 +1,184 @@
+#include "../cobs_parallel.h"
+#include "byte_vec.h"
+#include "doctest_wrapper.h"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+
+namespace {
+byte_vec_t encode(byte_vec_t const& dec) {
+  byte_vec_t enc(COBS_ENCODE_MAX(dec.size()));
+  size_t enc_len{ 0u };
+  byte_t const empty{ 0 };  // an empty vector's data() may be null
+  REQUIRE(cobs_encode(dec.empty() ? &empty : dec.data(),
+                      dec.size(),
+                      enc.data(),
+                      enc.size(),
+                      &enc_len) == COBS_RET_SUCCESS);
+  enc.resize(enc_len);
+  return enc;
+}
+
+struct popped {
+  bool ok;
+  cobs_ret_t status;
+  byte_vec_t dec;
+};
+
+popped pop(cobs::frame_ring& ring, size_t dec_max = 1024) {
+  popped p{ false, COBS_RET_ERR_BAD_ARG, byte_vec_t(std::max<size_t>(dec_max, 1)) };
+  size_t dec_len{ 12345 };
+  p.ok = ring.pop(p.dec.data(), dec_max, &dec_len, &p.status);
+  p.dec.resize(p.ok ? dec_len : 0);
+  return p;
+}
+}  // namespace
+
+TEST_CASE("frame_ring") {
+  cobs::frame_ring ring{ 16 };
+  REQUIRE(ring.capacity() == 16);
+  REQUIRE(!pop(ring).ok);
+
+  SUBCASE("Null pointers") {
+    byte_t dec[4];
+    size_t len;
+    cobs_ret_t status;
+    REQUIRE(ring.push(nullptr, 3) == 0);
+    REQUIRE(ring.push(byte_vec_t{ 0x01, 0x00 }.data(), 2) == 2);
+    REQUIRE(!ring.pop(nullptr, sizeof(dec), &len, &status));
+    REQUIRE(!ring.pop(dec, sizeof(dec), nullptr, &status));
+    REQUIRE(!ring.pop(dec, sizeof(dec), &len, nullptr));
+    REQUIRE(ring.pop(dec, sizeof(dec), &len, &status));
+    REQUIRE(status == COBS_RET_SUCCESS);
+    REQUIRE(len == 0);
+  }
+
+  SUBCASE("Frames only come out once their delimiter is in") {
+    byte_vec_t const enc{ encode(byte_vec_t{ 0x11, 0x00, 0x22 }) };
+    REQUIRE(ring.push(enc.data(), enc.size() - 1) == enc.size() - 1);
+    REQUIRE(!pop(ring).ok);
+    REQUIRE(ring.push(&enc.back(), 1) == 1);
+
+    popped const p{ pop(ring) };
+    REQUIRE(p.ok);
+    REQUIRE(p.status == COBS_RET_SUCCESS);
+    REQUIRE(p.dec == byte_vec_t{ 0x11, 0x00, 0x22 });
+    REQUIRE(!pop(ring).ok);
+  }
+
+  SUBCASE("Several frames in one push") {
+    byte_vec_t const a{ encode(byte_vec_t{ 0x01 }) }, b{ encode(byte_vec_t{}) },
+        c{ encode(byte_vec_t{ 0x00, 0x00 }) };
+    byte_vec_t stream{ a };
+    stream.insert(stream.end(), b.begin(), b.end());
+    stream.insert(stream.end(), c.begin(), c.end());
+    stream.push_back(0x05);  // start of a fourth
+    REQUIRE(ring.push(stream.data(), stream.size()) == stream.size());
+
+    REQUIRE(pop(ring).dec == byte_vec_t{ 0x01 });
+    REQUIRE(pop(ring).dec == byte_vec_t{});
+    REQUIRE(pop(ring).dec == byte_vec_t{ 0x00, 0x00 });
+    REQUIRE(!pop(ring).ok);
+  }
+
+  SUBCASE("Pushes stop when the ring is full") {
+    byte_vec_t const enc{ encode(byte_vec_t(13, 0x33)) };  // 15 bytes
+    REQUIRE(ring.push(enc.data(), enc.size()) == enc.size());
+    REQUIRE(ring.push(enc.data(), enc.size()) == 1);  // a frame's first byte
+    REQUIRE(ring.push(enc.data(), enc.size()) == 0);
+
+    REQUIRE(pop(ring).dec == byte_vec_t(13, 0x33));
+    REQUIRE(ring.push(enc.data() + 1, enc.size() - 1) == enc.size() - 1);  // wraps
+    REQUIRE(pop(ring).dec == byte_vec_t(13, 0x33));
+    REQUIRE(!pop(ring).ok);
+  }
+
+  SUBCASE("Bad frames are dropped") {
+    byte_vec_t const good{ encode(byte_vec_t{ 0x44 }) };
+    byte_vec_t stream{ 0x00, 0x03, 0x11, 0x00 };  // empty frame, then a zero in a block
+    stream.insert(stream.end(), good.begin(), good.end());
+    REQUIRE(ring.push(stream.data(), stream.size()) == stream.size());
+
+    popped p{ pop(ring) };
+    REQUIRE(p.ok);
+    REQUIRE(p.status == COBS_RET_ERR_BAD_PAYLOAD);
+    REQUIRE(p.dec.empty());
+    p = pop(ring);
+    REQUIRE(p.ok);
+    REQUIRE(p.status == COBS_RET_ERR_BAD_PAYLOAD);
+    REQUIRE(p.dec.empty());
+    p = pop(ring);
+    REQUIRE(p.status == COBS_RET_SUCCESS);
+    REQUIRE(p.dec == byte_vec_t{ 0x44 });
+  }
+
+  SUBCASE("Frames too big for the output are dropped") {
+    byte_vec_t const big{ encode(byte_vec_t{ 1, 2, 0, 4, 5 }) };
+    byte_vec_t const small{ encode(byte_vec_t{ 6 }) };
+    REQUIRE(ring.push(big.data(), big.size()) == big.size());
+    REQUIRE(ring.push(small.data(), small.size()) == small.size());
+
+    popped p{ pop(ring, 4) };
+    REQUIRE(p.ok);
+    REQUIRE(p.status == COBS_RET_ERR_EXHAUSTED);
+    REQUIRE(p.dec.empty());
+    p = pop(ring, 4);
+    REQUIRE(p.status == COBS_RET_SUCCESS);
+    REQUIRE(p.dec == byte_vec_t{ 6 });
+  }
+}
+
+TEST_CASE("frame_ring between two threads") {
+  auto constexpr FRAMES{ 20000u };
+  auto constexpr MAX_LEN{ 600u };
+  cobs::frame_ring ring{ 1024 };
+
+  // Both threads generate the same payloads from the same seed.
+  auto const payload{ [](std::mt19937& mt) {
+    byte_vec_t dec(mt() % MAX_LEN);
+    auto const zeros{ mt() % 4 };  // 0: none, 3: mostly zeros
+    std::generate(dec.begin(), dec.end(), [&]() {
+      return (mt() % 4 < zeros) ? byte_t{ 0 } : byte_t(mt() | 1);
+    });
+    return dec;
+  } };
+
+  std::thread producer{ [&]() {
+    std::mt19937 mt{ 1234 }, chunks{ 5678 };
+    for (unsigned i{ 0 }; i < FRAMES; ++i) {
+      byte_vec_t const enc{ encode(payload(mt)) };
+      size_t pos{ 0 };
+      while (pos < enc.size()) {
+        size_t const chunk{ std::min<size_t>(1 + (chunks() % 97), enc.size() - pos) };
+        size_t const n{ ring.push(enc.data() + pos, chunk) };
+        if (!n) {
+          std::this_thread::yield();
+        }
+        pos += n;
+      }
+    }
+  } };
+
+  std::mt19937 mt{ 1234 };
+  byte_vec_t dec(MAX_LEN);
+  unsigned mismatches{ 0 };
+  for (unsigned i{ 0 }; i < FRAMES;) {
+    size_t dec_len;
+    cobs_ret_t status;
+    if (!ring.pop(dec.data(), dec.size(), &dec_len, &status)) {
+      std::this_thread::yield();
+      continue;
+    }
+    byte_vec_t const expected{ payload(mt) };
+    mismatches += (status != COBS_RET_SUCCESS) || (dec_len != expected.size()) ||
+                  !std::equal(expected.begin(), expected.end(), dec.begin());
+    ++i;
+  }
+  producer.join();
+
+  REQUIRE(mismatches == 0);
+  size_t dec_len;
+  cobs_ret_t status;
+  REQUIRE(!ring.pop(dec.data(), dec.size(), &dec_len, &status));
+}
@@ -0,0 +1,174 @@
+#include "../cobs.h"
+#include "byte_vec.h"
+#include "doctest_wrapper.h"
+#include "kernel_guard.h"
+
+#include <algorithm>
+#include <random>
+
+namespace {
+byte_vec_t encode(byte_vec_t const& dec) {
+  byte_vec_t enc(COBS_ENCODE_MAX(dec.size()));
+  size_t enc_len{ 0u };
+  REQUIRE(cobs_encode(dec.data(), dec.size(), enc.data(), enc.size(), &enc_len) ==
+          COBS_RET_SUCCESS);
+  enc.resize(enc_len);
+  return enc;
+}
+
+byte_vec_t decode(byte_vec_t const& enc) {
+  byte_vec_t dec(enc.size());
+  size_t dec_len{ 0u };
+  REQUIRE(cobs_decode(enc.data(), enc.size(), dec.data(), dec.size(), &dec_len) ==
+          COBS_RET_SUCCESS);
+  dec.resize(dec_len);
+  return dec;
+}
+}  // namespace
+
+TEST_CASE("cobs_get_kernel") {
+  kernel_guard g;
+  REQUIRE(cobs_get_kernel() != COBS_KERNEL_AUTO);
+  REQUIRE(cobs_set_kernel(COBS_KERNEL_AUTO) == COBS_RET_SUCCESS);
+  REQUIRE(cobs_get_kernel() != COBS_KERNEL_AUTO);
+}
+
+TEST_CASE("cobs_set_kernel") {
+  kernel_guard g;
+
+  SUBCASE("Auto-selected kernel can be set explicitly") {
+    cobs_kernel_t const k{ cobs_get_kernel() };
+    REQUIRE(cobs_set_kernel(k) == COBS_RET_SUCCESS);
+    REQUIRE(cobs_get_kernel() == k);
+  }
+
+  SUBCASE("Invalid kernel is rejected and leaves selection unchanged") {
+    cobs_kernel_t const k{ cobs_get_kernel() };
+    REQUIRE(cobs_set_kernel(cobs_kernel_t(COBS_KERNEL_AVX2 + 1)) == COBS_RET_ERR_BAD_ARG);
+    REQUIRE(cobs_get_kernel() == k);
+  }
+
+  SUBCASE("Supported kernels stick") {
+    for (cobs_kernel_t k : s_kernels) {
+      if (cobs_set_kernel(k) == COBS_RET_SUCCESS) {
+        REQUIRE(cobs_get_kernel() == k);
+      }
+    }
+  }
+}
+
+TEST_CASE("Every kernel matches the scalar kernel") {
+  kernel_guard g;
+  std::mt19937 mt{ 24680u };
+
+  for (auto iter{ 0u }; iter < 200; ++iter) {
+    size_t const len = mt() % 4096;
+    byte_vec_t const src{ random_payload(mt, len) };
+
+    // Builds without runtime dispatch only have their one compile-time kernel.
+    (void)cobs_set_kernel(COBS_KERNEL_SCALAR);
+    byte_vec_t const expected{ encode(src) };
+
+    // Corrupt one byte to zero; every kernel must reach the same verdict on it.
+    byte_vec_t bad{ expected };
+    bad[mt() % (bad.size() - 1)] = 0;
+    byte_vec_t bad_expected(bad.size());
+    size_t bad_expected_len{ 0u };
+    cobs_ret_t const bad_expected_r{ cobs_decode(
+        bad.data(), bad.size(), bad_expected.data(), bad.size(), &bad_expected_len) };
+
+    for (cobs_kernel_t k : s_kernels) {
+      if (cobs_set_kernel(k) != COBS_RET_SUCCESS) {
+        continue;
+      }
+      CAPTURE(k);
+      byte_vec_t const enc{ encode(src) };
+      REQUIRE(enc == expected);
+      REQUIRE(decode(enc) == src);
+
+      // Incremental decode in small chunks exercises the block-straddling paths.
+      cobs_decode_inc_ctx_t ctx;
+      REQUIRE(cobs_decode_inc_begin(&ctx) == COBS_RET_SUCCESS);
+      byte_vec_t dec(len + 1);
+      size_t src_pos{ 0 }, dst_pos{ 0 };
+      bool complete{ false };
+      while (!complete) {
+        size_t const chunk{ std::min(size_t(1 + (mt() % 97)), enc.size() - src_pos) };
+        cobs_decode_inc_args_t const args{ .enc_src = enc.data() + src_pos,
+                                           .dec_dst = dec.data() + dst_pos,
+                                           .enc_src_max = chunk,
+                                           .dec_dst_max = dec.size() - dst_pos,
+                                           .crc = nullptr };
+        size_t src_len{ 0u }, dst_len{ 0u };
+        REQUIRE(cobs_decode_inc(&ctx, &args, &src_len, &dst_len, &complete) ==
+                COBS_RET_SUCCESS);
+        src_pos += src_len;
+        dst_pos += dst_len;
+      }
+      dec.resize(dst_pos);
+      REQUIRE(dec == src);
+
+      size_t checked_len{ 0u };
+      REQUIRE(cobs_decoded_len(enc.data(), enc.size(), &checked_len) == COBS_RET_SUCCESS);
+      REQUIRE(checked_len == src.size());
+
+      size_t exact_len{ 0u };
+      REQUIRE(cobs_encoded_len(src.data(), src.size(), &exact_len) == COBS_RET_SUCCESS);
+      REQUIRE(exact_len == enc.size());
+
+      // In-place encoding and decoding copy leftward over their own source.
+      byte_vec_t inplace_enc{ src };
+      inplace_enc.resize(COBS_ENCODE_MAX(src.size()));
+      size_t inplace_enc_len{ 0u };
+      REQUIRE(cobs_encode_inplace(inplace_enc.data(),
+                                  src.size(),
+                                  inplace_enc.size(),
+                                  &inplace_enc_len) == COBS_RET_SUCCESS);
+      inplace_enc.resize(inplace_enc_len);
+      REQUIRE(inplace_enc == enc);
+
+
+      byte_vec_t inplace{ enc };
+      size_t inplace_len{ 0u };
+      REQUIRE(cobs_decode_inplace(inplace.data(), inplace.size(), &inplace_len) ==
+              COBS_RET_SUCCESS);
+      inplace.resize(inplace_len);
+      REQUIRE(inplace == src);
+
+      byte_vec_t bad_dec(bad.size());
+      size_t bad_dec_len{ 0u };
+      REQUIRE(cobs_decode(
+                  bad.data(), bad.size(), bad_dec.data(), bad.size(), &bad_dec_len) ==
+              bad_expected_r);
+      if (bad_expected_r == COBS_RET_SUCCESS) {
+        REQUIRE(bad_dec_len == bad_expected_len);
+        REQUIRE(bad_dec == bad_expected);
+      }
+    }
+  }
+}
+
+TEST_CASE("Every kernel round-trips tinyframes") {
+  kernel_guard g;
+  std::mt19937 mt{ 13579u };
+
+  for (cobs_kernel_t k : s_kernels) {
+    if (cobs_set_kernel(k) != COBS_RET_SUCCESS) {
+      continue;
+    }
+    CAPTURE(k);
+    for (auto iter{ 0u }; iter < 200; ++iter) {
+      size_t const payload_len = mt() % (COBS_TINYFRAME_SAFE_BUFFER_SIZE - 2);
+      byte_vec_t buf{ random_payload(mt, payload_len + 2) };
+      buf.front() = COBS_TINYFRAME_SENTINEL_VALUE;
+      buf.back() = COBS_TINYFRAME_SENTINEL_VALUE;
+      byte_vec_t const original{ buf };
+
+      REQUIRE(cobs_encode_tinyframe(buf.data(), buf.size()) == COBS_RET_SUCCESS);
+      REQUIRE(buf.back() == 0x00);
+      REQUIRE(std::none_of(buf.begin(), buf.end() - 1, [](byte_t b) { return !b; }));
+      REQUIRE(cobs_decode_tinyframe(buf.data(), buf.size()) == COBS_RET_SUCCESS);
+      REQUIRE(buf == original);
+    }
+  }
+}
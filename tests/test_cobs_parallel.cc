@@ -0,0 +1,425 @@
+#include "../cobs_parallel.h"
+#include "byte_vec.h"
+#include "doctest_wrapper.h"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <vector>
+
+namespace {
+byte_vec_t encode(byte_vec_t const& dec) {
+  byte_vec_t enc(COBS_ENCODE_MAX(dec.size()));
+  size_t enc_len{ 0u };
+  byte_t const empty{ 0 };  // an empty vector's data() may be null
+  REQUIRE(cobs_encode(dec.empty() ? &empty : dec.data(),
+                      dec.size(),
+                      enc.data(),
+                      enc.size(),
+                      &enc_len) == COBS_RET_SUCCESS);
+  enc.resize(enc_len);
+  return enc;
+}
+
+byte_vec_t concat(std::vector<byte_vec_t> const& v) {
+  byte_vec_t out;
+  for (auto const& x : v) {
+    out.insert(out.end(), x.begin(), x.end());
+  }
+  return out;
+}
+
+struct batch {
+  cobs_ret_t ret;
+  std::vector<cobs_frame_t> frames;
+  byte_vec_t dec;
+  size_t tail_len;
+};
+
+batch decode_frames(cobs::thread_pool& pool,
+                    byte_vec_t const& enc,
+                    size_t dec_max,
+                    size_t frames_max) {
+  batch b{ COBS_RET_SUCCESS,
+           std::vector<cobs_frame_t>(std::max<size_t>(frames_max, 1)),
+           byte_vec_t(std::max<size_t>(dec_max, 1)),
+           0 };
+  size_t n{ 0 };
+  b.ret = cobs::decode_frames(pool,
+                              enc.data(),
+                              enc.size(),
+                              b.dec.data(),
+                              dec_max,
+                              b.frames.data(),
+                              frames_max,
+                              &n,
+                              &b.tail_len);
+  b.frames.resize(n);
+  return b;
+}
+
+byte_vec_t frame_bytes(batch const& b, size_t i) {
+  auto const first{ b.dec.begin() + static_cast<std::ptrdiff_t>(b.frames[i].dec_ofs) };
+  return byte_vec_t(first, first + static_cast<std::ptrdiff_t>(b.frames[i].dec_len));
+}
+}  // namespace
+
+TEST_CASE("thread_pool") {
+  for (unsigned const threads : { 1u, 2u, 5u }) {
+    cobs::thread_pool pool{ threads };
+    REQUIRE(pool.size() == threads);
+
+    for (unsigned const tasks : { 0u, 1u, 3u, 64u }) {
+      std::vector<std::atomic<unsigned>> hits(tasks);
+      pool.run(tasks, [&](unsigned i) { ++hits[i]; });
+      REQUIRE(std::all_of(hits.begin(), hits.end(), [](auto const& h) { return h == 1; }));
+    }
+  }
+
+  cobs::thread_pool pool;
+  REQUIRE(pool.size() >= 1);
+}
+
+TEST_CASE("cobs::decode_frames bad args") {
+  cobs::thread_pool pool{ 2 };
+  byte_t enc[]{ 0x01, 0x00 }, dec[4];
+  cobs_frame_t frames[2];
+  size_t n, tail;
+
+  REQUIRE(cobs::decode_frames(pool, nullptr, 2, dec, 4, frames, 2, &n, &tail) ==
+          COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs::decode_frames(pool, enc, 2, nullptr, 4, frames, 2, &n, &tail) ==
+          COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs::decode_frames(pool, enc, 2, dec, 4, nullptr, 2, &n, &tail) ==
+          COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs::decode_frames(pool, enc, 2, dec, 4, frames, 2, nullptr, &tail) ==
+          COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs::decode_frames(pool, enc, 2, dec, 4, frames, 2, &n, nullptr) ==
+          COBS_RET_ERR_BAD_ARG);
+}
+
+TEST_CASE("cobs::decode_frames") {
+  cobs::thread_pool pool{ 3 };
+
+  SUBCASE("Frames decode in place of their encodings") {
+    std::vector<byte_vec_t> const payloads{ { 0x11 }, {}, { 0x00, 0x22, 0x00 }, { 0x33 } };
+    std::vector<byte_vec_t> encs;
+    std::transform(payloads.begin(), payloads.end(), std::back_inserter(encs), encode);
+    byte_vec_t const enc{ concat(encs) };
+
+    auto const b{ decode_frames(pool, enc, enc.size(), 8) };
+    REQUIRE(b.ret == COBS_RET_SUCCESS);
+    REQUIRE(b.tail_len == 0);
+    REQUIRE(b.frames.size() == payloads.size());
+    size_t ofs{ 0 };
+    for (size_t i{ 0 }; i < payloads.size(); ++i) {
+      REQUIRE(b.frames[i].status == COBS_RET_SUCCESS);
+      REQUIRE(b.frames[i].dec_ofs == ofs);
+      REQUIRE(frame_bytes(b, i) == payloads[i]);
+      ofs += encs[i].size();
+    }
+  }
+
+  SUBCASE("Incomplete final frame is left in the tail") {
+    byte_vec_t enc{ concat({ encode({ 0x11, 0x22 }), encode({ 0x33, 0x44, 0x55 }) }) };
+    enc.pop_back();
+    auto const b{ decode_frames(pool, enc, enc.size(), 8) };
+    REQUIRE(b.ret == COBS_RET_SUCCESS);
+    REQUIRE(b.frames.size() == 1);
+    REQUIRE(frame_bytes(b, 0) == byte_vec_t{ 0x11, 0x22 });
+    REQUIRE(b.tail_len == 4);
+  }
+
+  SUBCASE("Bad frames are reported and skipped") {
+    byte_vec_t const enc{ concat({ encode({ 0x11 }),
+                                   byte_vec_t{ 0x05, 0x01, 0x00 },  // jumps over a zero
+                                   byte_vec_t{ 0x00 },              // empty frame
+                                   encode({ 0x22 }) }) };
+    auto const b{ decode_frames(pool, enc, enc.size(), 8) };
+    REQUIRE(b.ret == COBS_RET_SUCCESS);
+    REQUIRE(b.tail_len == 0);
+    REQUIRE(b.frames.size() == 4);
+    REQUIRE(b.frames[0].status == COBS_RET_SUCCESS);
+    REQUIRE(b.frames[1].status == COBS_RET_ERR_BAD_PAYLOAD);
+    REQUIRE(b.frames[1].dec_len == 0);
+    REQUIRE(b.frames[2].status == COBS_RET_ERR_BAD_PAYLOAD);
+    REQUIRE(b.frames[2].dec_len == 0);
+    REQUIRE(b.frames[3].status == COBS_RET_SUCCESS);
+    REQUIRE(frame_bytes(b, 3) == byte_vec_t{ 0x22 });
+  }
+
+  SUBCASE("Frames that don't fit stay in the tail") {
+    byte_vec_t const first{ encode({ 0x11 }) }, second{ encode({ 0x22, 0x33 }) };
+    byte_vec_t const enc{ concat({ first, second }) };
+    REQUIRE(decode_frames(pool, enc, enc.size(), 1).tail_len == second.size());
+    REQUIRE(decode_frames(pool, enc, enc.size() - 2, 8).tail_len == 0);  // just fits
+    REQUIRE(decode_frames(pool, enc, enc.size() - 3, 8).tail_len == second.size());
+  }
+
+  SUBCASE("Bad frame that overflows the output buffer is still consumed") {
+    byte_vec_t const enc{ 0x05, 'a', 0x00, 0x02, 0x11, 0x00 };
+    auto const b{ decode_frames(pool, enc, 1, 8) };
+    REQUIRE(b.ret == COBS_RET_SUCCESS);
+    REQUIRE(b.frames.size() == 1);
+    REQUIRE(b.frames[0].status == COBS_RET_ERR_BAD_PAYLOAD);
+    REQUIRE(b.tail_len == 3);
+  }
+
+  SUBCASE("Exhausted if not even the first frame fits") {
+    byte_vec_t const enc{ encode({ 0x11, 0x22, 0x33 }) };
+    REQUIRE(decode_frames(pool, enc, 2, 8).ret == COBS_RET_ERR_EXHAUSTED);
+    REQUIRE(decode_frames(pool, enc, 16, 0).ret == COBS_RET_ERR_EXHAUSTED);
+  }
+}
+
+TEST_CASE("cobs::decode_frames: many random frames across thread counts") {
+  std::mt19937 mt{ 4321u };
+  std::vector<byte_vec_t> payloads(2000);
+  for (auto& p : payloads) {
+    p.resize(mt() % ((mt() % 8) ? 300 : 5000));
+    std::generate(p.begin(), p.end(), [&]() { return byte_t((mt() % 4) ? mt() : 0); });
+  }
+  payloads.back().assign(100, 0x42);
+  std::vector<byte_vec_t> encs;
+  std::transform(payloads.begin(), payloads.end(), std::back_inserter(encs), encode);
+  byte_vec_t enc{ concat(encs) };
+  enc.resize(enc.size() - 7);  // cut the last frame short
+
+  for (unsigned const threads : { 1u, 2u, 3u, 8u }) {
+    cobs::thread_pool pool{ threads };
+    auto const b{ decode_frames(pool, enc, enc.size(), payloads.size()) };
+    REQUIRE(b.ret == COBS_RET_SUCCESS);
+    REQUIRE(b.frames.size() == payloads.size() - 1);
+    REQUIRE(b.tail_len == encs.back().size() - 7);
+    for (size_t i{ 0 }; i < b.frames.size(); ++i) {
+      REQUIRE(b.frames[i].status == COBS_RET_SUCCESS);
+      REQUIRE(frame_bytes(b, i) == payloads[i]);
+    }
+  }
+}
+
+TEST_CASE("cobs::decode_frames agrees with cobs_decode_frames on good and bad frames") {
+  std::mt19937 mt{ 8765u };
+  cobs::thread_pool pool{ 3 };
+  for (auto i{ 0u }; i < 200; ++i) {
+    std::vector<byte_vec_t> encs(1 + (mt() % 40));
+    for (auto& e : encs) {
+      e = encode(random_payload(mt, mt() % ((mt() % 8) ? 40 : 600)));
+      auto const kind{ mt() % 5 };
+      if (kind == 0) {
+        e[0] = byte_t(e.size() + (mt() % 8));  // the first code jumps the delimiter
+      } else if (kind == 1) {
+        e = byte_vec_t{ 0x00 };  // empty frame
+      }
+    }
+    byte_vec_t enc{ concat(encs) };
+    enc.resize(enc.size() - (mt() % 3));  // maybe cut the last frame short
+
+    auto const par{ decode_frames(pool, enc, enc.size(), encs.size()) };
+
+    std::vector<cobs_frame_t> frames(encs.size());
+    byte_vec_t dec(std::max<size_t>(enc.size(), 1));
+    size_t n, tail_len;
+    cobs_ret_t const ret{ cobs_decode_frames(enc.data(),
+                                             enc.size(),
+                                             dec.data(),
+                                             enc.size(),
+                                             frames.data(),
+                                             frames.size(),
+                                             &n,
+                                             &tail_len) };
+
+    REQUIRE(par.ret == ret);
+    REQUIRE(par.frames.size() == n);
+    REQUIRE(par.tail_len == tail_len);
+    for (size_t f{ 0 }; f < n; ++f) {
+      REQUIRE(par.frames[f].status == frames[f].status);
+      auto const first{ dec.begin() + static_cast<std::ptrdiff_t>(frames[f].dec_ofs) };
+      REQUIRE(frame_bytes(par, f) ==
+              byte_vec_t(first, first + static_cast<std::ptrdiff_t>(frames[f].dec_len)));
+    }
+  }
+}
+
+TEST_CASE("cobs::encode bad args") {
+  cobs::thread_pool pool{ 2 };
+  byte_t dec[1]{}, enc[4];
+  size_t len;
+
+  REQUIRE(cobs::encode(pool, nullptr, 1, enc, 4, &len) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs::encode(pool, dec, 1, nullptr, 4, &len) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs::encode(pool, dec, 1, enc, 4, nullptr) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs::encode(pool, dec, 1, enc, 1, &len) == COBS_RET_ERR_BAD_ARG);
+}
+
+TEST_CASE("cobs::encode matches cobs_encode") {
+  std::mt19937 mt{ 8765u };
+  size_t constexpr len{ 1024 * 1024 };
+
+  // Mostly random bytes, with zeros landing right after full 254-byte blocks, long
+  // zero-free stretches, and runs of zeros, so the split points land on every case.
+  byte_vec_t dec(len);
+  std::generate(dec.begin(), dec.end(), [&]() { return byte_t(mt()); });
+  for (size_t i{ 0 }; i < 200; ++i) {
+    byte_t* const p{ dec.data() + (mt() % (len - 20000)) };
+    switch (mt() % 3) {
+      case 0: {
+        size_t const n{ 254 * (1 + (mt() % 3)) };
+        p[0] = 0;
+        std::fill_n(p + 1, n, 0x11);
+        p[n + 1] = 0;
+      } break;
+      case 1: std::fill_n(p, 20000, 0x22); break;
+      case 2: std::fill_n(p, mt() % 600, 0); break;
+    }
+  }
+
+  auto const check{ [](cobs::thread_pool& pool, byte_vec_t const& d) {
+    byte_vec_t expected(COBS_ENCODE_MAX(d.size())), actual(expected.size());
+    size_t expected_len, actual_len;
+    REQUIRE(cobs_encode(d.data(),
+                        d.size(),
+                        expected.data(),
+                        expected.size(),
+                        &expected_len) == COBS_RET_SUCCESS);
+    REQUIRE(cobs::encode(pool,
+                         d.data(),
+                         d.size(),
+                         actual.data(),
+                         actual.size(),
+                         &actual_len) == COBS_RET_SUCCESS);
+    REQUIRE(actual_len == expected_len);
+    REQUIRE(actual == expected);
+
+    // One byte short of the exact encoded length isn't enough.
+    REQUIRE(cobs::encode(pool,
+                         d.data(),
+                         d.size(),
+                         actual.data(),
+                         expected_len - 1,
+                         &actual_len) == COBS_RET_ERR_EXHAUSTED);
+  } };
+
+  for (unsigned const threads : { 1u, 2u, 3u, 8u }) {
+    cobs::thread_pool pool{ threads };
+    check(pool, dec);
+
+    SUBCASE("Ends with a zero") {
+      byte_vec_t d{ dec };
+      d.back() = 0;
+      check(pool, d);
+    }
+
+    SUBCASE("Ends with a full block") {
+      byte_vec_t d{ dec };
+      std::fill(d.end() - 254 * 3, d.end(), 0x33);
+      check(pool, d);
+    }
+
+    SUBCASE("All zeros") {
+      check(pool, byte_vec_t(len));
+    }
+
+    SUBCASE("No zeros") {
+      check(pool, byte_vec_t(len, 0x44));
+    }
+
+    SUBCASE("Zeros spaced so splits land right after full blocks") {
+      byte_vec_t d(len, 0x55);
+      for (size_t i{ 254 }; i < len; i += 255) {
+        d[i] = 0;
+      }
+      check(pool, d);
+    }
+  }
+}
+
+TEST_CASE("cobs::decode bad args") {
+  cobs::thread_pool pool{ 2 };
+  byte_t enc[]{ 0x01, 0x00 }, dec[4];
+  size_t len;
+
+  REQUIRE(cobs::decode(pool, nullptr, 2, dec, 4, &len) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs::decode(pool, enc, 2, nullptr, 4, &len) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs::decode(pool, enc, 2, dec, 4, nullptr) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs::decode(pool, enc, 1, dec, 4, &len) == COBS_RET_ERR_BAD_ARG);
+}
+
+TEST_CASE("cobs::decode matches cobs_decode") {
+  std::mt19937 mt{ 2468u };
+  size_t constexpr len{ 1024 * 1024 };
+
+  auto const check{ [](cobs::thread_pool& pool, byte_vec_t const& enc, size_t dec_max) {
+    byte_vec_t expected(std::max<size_t>(dec_max, 1)), actual(expected.size());
+    size_t expected_len{ 0 }, actual_len{ 0 };
+    cobs_ret_t const expected_ret{
+      cobs_decode(enc.data(), enc.size(), expected.data(), dec_max, &expected_len)
+    };
+    REQUIRE(cobs::decode(pool,
+                         enc.data(),
+                         enc.size(),
+                         actual.data(),
+                         dec_max,
+                         &actual_len) == expected_ret);
+    if (expected_ret != COBS_RET_ERR_BAD_PAYLOAD) {
+      REQUIRE(actual_len == expected_len);
+      REQUIRE(std::equal(expected.begin(),
+                         expected.begin() + static_cast<std::ptrdiff_t>(expected_len),
+                         actual.begin()));
+    }
+    return expected_ret;
+  } };
+
+  for (unsigned const threads : { 1u, 2u, 3u, 8u }) {
+    cobs::thread_pool pool{ threads };
+
+    SUBCASE("Random payloads") {
+      for (unsigned const zero_every : { 2u, 100u, 254u, 1000u, 0u }) {
+        byte_vec_t dec(len);
+        std::generate(dec.begin(), dec.end(), [&]() {
+          return byte_t((zero_every && !(mt() % zero_every)) ? 0 : 1 + (mt() % 255));
+        });
+        byte_vec_t const enc{ encode(dec) };
+        REQUIRE(check(pool, enc, len) == COBS_RET_SUCCESS);
+      }
+    }
+
+    SUBCASE("Full blocks followed by zeros") {
+      byte_vec_t dec(len, 0x11);
+      for (size_t i{ 254 }; i < len; i += 255 + (i % 3)) {
+        dec[i] = 0;
+      }
+      REQUIRE(check(pool, encode(dec), len) == COBS_RET_SUCCESS);
+    }
+
+    SUBCASE("Bytes after the delimiter are ignored") {
+      byte_vec_t enc{ encode(byte_vec_t(len, 0x22)) };
+      enc.insert(enc.end(), 1000, 0x33);
+      REQUIRE(check(pool, enc, len) == COBS_RET_SUCCESS);
+    }
+
+    SUBCASE("Errors") {
+      byte_vec_t dec(len);
+      std::generate(dec.begin(), dec.end(), [&]() { return byte_t(mt()); });
+      byte_vec_t const enc{ encode(dec) };
+
+      REQUIRE(check(pool, enc, len - 1) == COBS_RET_ERR_EXHAUSTED);
+      REQUIRE(check(pool, byte_vec_t(enc.begin(), enc.end() - 1), len) ==
+              COBS_RET_ERR_EXHAUSTED);
+
+      for (size_t const at : { size_t{ 5 }, len / 2, len - 5 }) {
+        byte_vec_t bad{ enc };
+        size_t i{ at };
+        while (!bad[i] || !bad[i - 1] || !bad[i + 1]) {
+          ++i;
+        }
+        bad[i] = 0;  // a zero inside a block, or an early delimiter
+        check(pool, bad, len);
+      }
+
+      byte_vec_t bad{ enc };
+      bad[0] = 0;
+      check(pool, bad, len);
+    }
+  }
+}
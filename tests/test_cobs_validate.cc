@@ -0,0 +1,122 @@
+#include "../cobs.h"
+#include "byte_vec.h"
+#include "doctest_wrapper.h"
+
+#include <algorithm>
+#include <random>
+
+namespace {
+byte_vec_t encode(byte_vec_t const& dec) {
+  byte_vec_t enc(COBS_ENCODE_MAX(dec.size()));
+  size_t enc_len{ 0u };
+  byte_t const empty{ 0 };  // an empty vector's data() may be null
+  REQUIRE(cobs_encode(dec.empty() ? &empty : dec.data(),
+                      dec.size(),
+                      enc.data(),
+                      enc.size(),
+                      &enc_len) == COBS_RET_SUCCESS);
+  enc.resize(enc_len);
+  return enc;
+}
+
+struct result {
+  cobs_ret_t ret;
+  size_t dec_len, err_ofs;
+};
+
+result validate(byte_vec_t const& enc) {
+  result r{ COBS_RET_SUCCESS, ~size_t{ 0 }, ~size_t{ 0 } };
+  r.ret = cobs_validate(enc.data(), enc.size(), &r.dec_len, &r.err_ofs);
+  return r;
+}
+}  // namespace
+
+TEST_CASE("cobs_validate validation") {
+  byte_t const enc[]{ 0x01, 0x00 };
+  size_t dec_len, err_ofs;
+
+  REQUIRE(cobs_validate(nullptr, 2, &dec_len, &err_ofs) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_validate(enc, 2, nullptr, &err_ofs) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_validate(enc, 2, &dec_len, nullptr) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_validate(enc, 1, &dec_len, &err_ofs) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_decoded_len(nullptr, 2, &dec_len) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_decoded_len(enc, 2, nullptr) == COBS_RET_ERR_BAD_ARG);
+  REQUIRE(cobs_decoded_len(enc, 0, &dec_len) == COBS_RET_ERR_BAD_ARG);
+}
+
+TEST_CASE("cobs_validate") {
+  SUBCASE("Valid frames") {
+    REQUIRE(validate({ 0x01, 0x00 }).dec_len == 0);
+    REQUIRE(validate({ 0x01, 0x01, 0x00 }).dec_len == 1);
+    REQUIRE(validate({ 0x02, 0x11, 0x02, 0x22, 0x00 }).dec_len == 3);
+    for (size_t const len : { 253u, 254u, 255u, 508u, 509u }) {
+      auto const r{ validate(encode(byte_vec_t(len, 0x42))) };
+      REQUIRE(r.ret == COBS_RET_SUCCESS);
+      REQUIRE(r.dec_len == len);
+    }
+  }
+
+  SUBCASE("Bytes after the delimiter are ignored") {
+    auto const r{ validate({ 0x02, 0x11, 0x00, 0x00, 0x05 }) };
+    REQUIRE(r.ret == COBS_RET_SUCCESS);
+    REQUIRE(r.dec_len == 1);
+  }
+
+  SUBCASE("Leading zero") {
+    auto const r{ validate({ 0x00, 0x11, 0x00 }) };
+    REQUIRE(r.ret == COBS_RET_ERR_BAD_PAYLOAD);
+    REQUIRE(r.err_ofs == 0);
+  }
+
+  SUBCASE("Zero inside a block") {
+    auto const r{ validate({ 0x02, 0x11, 0x04, 0x22, 0x00, 0x33, 0x00 }) };
+    REQUIRE(r.ret == COBS_RET_ERR_BAD_PAYLOAD);
+    REQUIRE(r.err_ofs == 4);
+  }
+
+  SUBCASE("Zero inside a truncated block") {
+    auto const r{ validate({ 0x09, 0x11, 0x00 }) };
+    REQUIRE(r.ret == COBS_RET_ERR_BAD_PAYLOAD);
+    REQUIRE(r.err_ofs == 2);
+  }
+
+  SUBCASE("Missing delimiter") {
+    auto const r{ validate({ 0x02, 0x11, 0x02, 0x22 }) };
+    REQUIRE(r.ret == COBS_RET_ERR_BAD_PAYLOAD);
+    REQUIRE(r.err_ofs == 4);
+    auto const r2{ validate({ 0x03, 0x11, 0x22 }) };
+    REQUIRE(r2.ret == COBS_RET_ERR_BAD_PAYLOAD);
+    REQUIRE(r2.err_ofs == 3);
+  }
+}
+
+TEST_CASE("cobs_validate: random frames agree with cobs_decode") {
+  std::mt19937 mt{ 11235u };
+  for (auto iter{ 0u }; iter < 2000; ++iter) {
+    byte_vec_t const dec{ random_payload(mt, mt() % 3000) };
+    byte_vec_t enc{ encode(dec) };
+
+    size_t dec_len{ 0u };
+    REQUIRE(cobs_decoded_len(enc.data(), enc.size(), &dec_len) == COBS_RET_SUCCESS);
+    REQUIRE(dec_len == dec.size());
+
+    // Corrupt a byte, then check that cobs_decode into a buffer of exactly the validated
+    // size succeeds if and only if validation did.
+    enc[mt() % enc.size()] = byte_t((mt() % 2) ? mt() : 0);
+    auto const r{ validate(enc) };
+    byte_vec_t out(std::max(enc.size(), size_t{ 1 }));
+    size_t out_len{ 0u };
+    cobs_ret_t const decode_r{ cobs_decode(enc.data(),
+                                           enc.size(),
+                                           out.data(),
+                                           (r.ret == COBS_RET_SUCCESS) ? r.dec_len
+                                                                       : out.size(),
+                                           &out_len) };
+    REQUIRE((decode_r == COBS_RET_SUCCESS) == (r.ret == COBS_RET_SUCCESS));
+    if (r.ret == COBS_RET_SUCCESS) {
+      REQUIRE(out_len == r.dec_len);
+    } else {
+      REQUIRE(r.err_ofs <= enc.size());
+    }
+  }
+}
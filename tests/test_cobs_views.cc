@@ -0,0 +1,127 @@
+#include "../cobs_views.h"
+#include "byte_vec.h"
+#include "doctest_wrapper.h"
+
+#include <list>
+#include <random>
+#include <string>
+
+namespace {
+static_assert(std::ranges::view<cobs::encode_view<std::views::all_t<byte_vec_t&>>>);
+static_assert(std::ranges::input_range<cobs::encode_view<std::views::all_t<byte_vec_t&>>>);
+static_assert(std::ranges::input_range<cobs::decode_view<std::views::all_t<byte_vec_t&>>>);
+
+byte_vec_t encode(byte_vec_t const& dec) {
+  byte_vec_t enc(COBS_ENCODE_MAX(dec.size()));
+  size_t enc_len{ 0u };
+  byte_t const empty{ 0 };  // an empty vector's data() may be null
+  REQUIRE(cobs_encode(dec.empty() ? &empty : dec.data(),
+                      dec.size(),
+                      enc.data(),
+                      enc.size(),
+                      &enc_len) == COBS_RET_SUCCESS);
+  enc.resize(enc_len);
+  return enc;
+}
+
+template <class R>
+byte_vec_t collect(R&& r) {
+  byte_vec_t out;
+  for (std::byte const b : r) {
+    out.push_back(byte_t(b));
+  }
+  return out;
+}
+
+template <class R>
+byte_vec_t collect_chunks(R&& r, size_t* out_chunks = nullptr) {
+  byte_vec_t out;
+  size_t n{ 0 };
+  for (std::span<std::byte const> const chunk : r.chunks()) {
+    REQUIRE(!chunk.empty());
+    REQUIRE(chunk.size() <= cobs::view_chunk_size);
+    auto const* const p{ reinterpret_cast<byte_t const*>(chunk.data()) };
+    out.insert(out.end(), p, p + chunk.size());
+    ++n;
+  }
+  if (out_chunks) {
+    *out_chunks = n;
+  }
+  return out;
+}
+}  // namespace
+
+TEST_CASE("cobs::views::encode") {
+  SUBCASE("Empty payload") {
+    byte_vec_t const dec;
+    REQUIRE(collect(dec | cobs::views::encode) == byte_vec_t{ 0x01, 0x00 });
+    REQUIRE(collect_chunks(cobs::views::encode(dec)) == byte_vec_t{ 0x01, 0x00 });
+  }
+
+  SUBCASE("Strings and std::byte ranges") {
+    std::string const s{ "a\0b", 3 };
+    REQUIRE(collect(s | cobs::views::encode) ==
+            byte_vec_t{ 0x02, 'a', 0x02, 'b', 0x00 });
+    std::array const b{ std::byte{ 0x11 }, std::byte{ 0x22 } };
+    REQUIRE(collect(b | cobs::views::encode) == byte_vec_t{ 0x03, 0x11, 0x22, 0x00 });
+  }
+
+  SUBCASE("Matches cobs_encode") {
+    std::mt19937 mt{ 1234 };
+    for (size_t const len : { 1u, 253u, 254u, 255u, 511u, 512u, 513u, 4000u, 70000u }) {
+      byte_vec_t const dec{ random_payload(mt, len) };
+      byte_vec_t const expected{ encode(dec) };
+      REQUIRE(collect(dec | cobs::views::encode) == expected);
+
+      size_t chunks;
+      REQUIRE(collect_chunks(dec | cobs::views::encode, &chunks) == expected);
+      REQUIRE(chunks <= (expected.size() + cobs::view_chunk_size - 1) /
+                            cobs::view_chunk_size + 1);
+
+      std::list<byte_t> const list(dec.begin(), dec.end());  // not contiguous
+      REQUIRE(collect(list | cobs::views::encode) == expected);
+      auto const gen{ std::views::iota(size_t{ 0 }, len) |
+                      std::views::transform([&](size_t i) { return dec[i]; }) };
+      REQUIRE(collect_chunks(gen | cobs::views::encode) == expected);
+    }
+  }
+}
+
+TEST_CASE("cobs::views::decode") {
+  SUBCASE("Round trip through both views") {
+    std::mt19937 mt{ 5678 };
+    for (size_t const len : { 0u, 1u, 254u, 255u, 512u, 513u, 70000u }) {
+      byte_vec_t const dec{ random_payload(mt, len) };
+      auto v{ dec | cobs::views::encode | cobs::views::decode };
+      REQUIRE(collect(v) == dec);
+      REQUIRE(v.status() == COBS_RET_SUCCESS);
+
+      byte_vec_t const enc{ encode(dec) };
+      auto c{ cobs::views::decode(enc) };
+      REQUIRE(collect_chunks(c) == dec);
+      REQUIRE(c.status() == COBS_RET_SUCCESS);
+    }
+  }
+
+  SUBCASE("Stops at the delimiter") {
+    byte_vec_t const enc{ 0x02, 0x11, 0x01, 0x00, 0x02, 0x22, 0x00 };
+    auto v{ enc | cobs::views::decode };
+    REQUIRE(collect(v) == byte_vec_t{ 0x11, 0x00 });
+    REQUIRE(v.status() == COBS_RET_SUCCESS);
+  }
+
+  SUBCASE("Missing delimiter") {
+    byte_vec_t const enc{ 0x03, 0x11, 0x22 };
+    auto v{ enc | cobs::views::decode };
+    REQUIRE(v.status() == COBS_RET_ERR_EXHAUSTED);
+    REQUIRE(collect(v) == byte_vec_t{ 0x11, 0x22 });
+    REQUIRE(v.status() == COBS_RET_ERR_EXHAUSTED);
+  }
+
+  SUBCASE("Malformed frame") {
+    byte_vec_t const enc{ 0x03, 0x11, 0x00, 0x22, 0x00 };
+    auto v{ enc | cobs::views::decode };
+    REQUIRE(collect(v).size() <= 1);
+    REQUIRE(v.status() == COBS_RET_ERR_BAD_PAYLOAD);
+  }
+}